@@ -0,0 +1,394 @@
+#define _XOPEN_SOURCE 700
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <dirent.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "batch.h"
+#include "linked_list.h"
+#include "parallel.h"
+#include "simulation.h"
+#include "utils.h"
+
+#define BATCH_IO_BUFFER (64 * 1024)
+#define BATCH_PATH_MAX 4096
+
+typedef struct {
+    FILE* spool;
+    long offset;
+    long length;
+} BatchBlock;
+
+typedef struct {
+    char** files;
+    BatchBlock* blocks;
+    int file_count;
+    int next_file;
+    pthread_mutex_t lock;
+    const BatchOptions* options;
+} BatchJob;
+
+typedef struct {
+    pthread_t thread;
+    BatchJob* job;
+    char* read_buffer;
+    char* write_buffer;
+    char path[BATCH_PATH_MAX];
+    FILE* spool;
+    long files_done;
+    long files_failed;
+    long processes;
+} BatchWorker;
+
+static void add_file(char*** files, int* count, int* capacity, const char* path) {
+    if (*count == *capacity) {
+        *capacity = *capacity ? *capacity * 2 : 64;
+        *files = (char**)realloc(*files, *capacity * sizeof(char*));
+        if (!*files) {
+            perror("Failed to grow batch file list");
+            exit(EXIT_FAILURE);
+        }
+    }
+    (*files)[*count] = strdup(path);
+    if (!(*files)[*count]) {
+        perror("Failed to store batch file name");
+        exit(EXIT_FAILURE);
+    }
+    (*count)++;
+}
+
+static int compare_names(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+static char** list_directory(const char* dirname, int* count) {
+    DIR* dir = opendir(dirname);
+    if (!dir) {
+        perror("Error opening batch directory");
+        exit(EXIT_FAILURE);
+    }
+    
+    char** files = NULL;
+    int capacity = 0;
+    char path[BATCH_PATH_MAX];
+    struct dirent* entry;
+    *count = 0;
+    
+    while ((entry = readdir(dir))) {
+        if (entry->d_name[0] == '.') continue;
+        
+        snprintf(path, sizeof(path), "%s/%s", dirname, entry->d_name);
+        struct stat info;
+        if (stat(path, &info) == 0 && S_ISREG(info.st_mode)) {
+            add_file(&files, count, &capacity, path);
+        }
+    }
+    
+    closedir(dir);
+    qsort(files, *count, sizeof(char*), compare_names);
+    return files;
+}
+
+static char** read_manifest(const char* filename, int* count) {
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        perror("Error opening batch manifest");
+        exit(EXIT_FAILURE);
+    }
+    
+    char** files = NULL;
+    int capacity = 0;
+    char line[BATCH_PATH_MAX];
+    *count = 0;
+    
+    while (fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (strlen(line) == 0 || line[0] == '#') continue;
+        add_file(&files, count, &capacity, line);
+    }
+    
+    fclose(file);
+    return files;
+}
+
+static const char* base_name(const char* path) {
+    const char* slash = strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
+
+static int compare_base_names(const void* a, const void* b) {
+    return strcmp(base_name(*(char* const*)a), base_name(*(char* const*)b));
+}
+
+static void parent_directory(const char* path, char* buffer, size_t size) {
+    const char* slash = strrchr(path, '/');
+    if (!slash) {
+        snprintf(buffer, size, ".");
+    } else if (slash == path) {
+        snprintf(buffer, size, "/");
+    } else {
+        snprintf(buffer, size, "%.*s", (int)(slash - path), path);
+    }
+}
+
+/* Refuses runs where two inputs would share an output name or where an
+ * output could overwrite an input that another worker is still reading. */
+static int check_destination(char** files, int file_count, const BatchOptions* options) {
+    char** sorted = (char**)malloc((file_count ? file_count : 1) * sizeof(char*));
+    if (!sorted) {
+        perror("Failed to check batch outputs");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(sorted, files, file_count * sizeof(char*));
+    qsort(sorted, file_count, sizeof(char*), compare_base_names);
+    
+    for (int i = 1; i < file_count; i++) {
+        if (strcmp(base_name(sorted[i - 1]), base_name(sorted[i])) == 0) {
+            fprintf(stderr, "Error: %s and %s would both be written as %s\n",
+                    sorted[i - 1], sorted[i], base_name(sorted[i]));
+            free(sorted);
+            return -1;
+        }
+    }
+    free(sorted);
+    
+    char destination[PATH_MAX];
+    if (!realpath(options->destination, destination)) {
+        if (options->combined) return 0;
+        fprintf(stderr, "Error: Output directory %s: ", options->destination);
+        perror(NULL);
+        return -1;
+    }
+    
+    char path[BATCH_PATH_MAX];
+    char resolved[PATH_MAX];
+    for (int i = 0; i < file_count; i++) {
+        if (options->combined) {
+            snprintf(path, sizeof(path), "%s", files[i]);
+        } else {
+            parent_directory(files[i], path, sizeof(path));
+        }
+        if (realpath(path, resolved) && strcmp(resolved, destination) == 0) {
+            fprintf(stderr, "Error: Output %s would overwrite input %s\n", options->destination, files[i]);
+            return -1;
+        }
+    }
+    
+    return 0;
+}
+
+static void simulate_file(BatchWorker* worker, int index) {
+    const BatchOptions* options = worker->job->options;
+    const char* input_path = worker->job->files[index];
+    
+    FILE* input = fopen(input_path, "r");
+    if (!input) {
+        fprintf(stderr, "Warning: Skipping %s: ", input_path);
+        perror(NULL);
+        worker->files_failed++;
+        return;
+    }
+    setvbuf(input, worker->read_buffer, _IOFBF, BATCH_IO_BUFFER);
+    ProcessList* all_processes = read_input_stream(input);
+    fclose(input);
+    
+    int queue_count;
+    ScheduleResult*** results = schedule_queues(all_processes, &queue_count, RESULT_WAITING, options->algorithms, 0);
+    int output_ok = 1;
+    
+    if (options->combined) {
+        BatchBlock* block = &worker->job->blocks[index];
+        block->spool = worker->spool;
+        block->offset = ftell(worker->spool);
+        fprintf(worker->spool, "# %s\n", base_name(input_path));
+        write_results(worker->spool, results, queue_count);
+        block->length = ftell(worker->spool) - block->offset;
+        if (ferror(worker->spool) || block->offset < 0 || block->length < 0) {
+            fprintf(stderr, "Warning: Cannot spool results for %s\n", input_path);
+            block->spool = NULL;
+            output_ok = 0;
+        }
+    } else {
+        snprintf(worker->path, sizeof(worker->path), "%s/%s", options->destination, base_name(input_path));
+        FILE* output = fopen(worker->path, "w");
+        if (output) {
+            setvbuf(output, worker->write_buffer, _IOFBF, BATCH_IO_BUFFER);
+            write_results(output, results, queue_count);
+            int failed = ferror(output);
+            if (fclose(output) != 0 || failed) {
+                fprintf(stderr, "Error writing %s\n", worker->path);
+                output_ok = 0;
+            }
+        } else {
+            fprintf(stderr, "Warning: Cannot write %s: ", worker->path);
+            perror(NULL);
+            output_ok = 0;
+        }
+    }
+    
+    if (output_ok) {
+        worker->files_done++;
+        worker->processes += all_processes->count;
+    } else {
+        worker->files_failed++;
+    }
+    
+    free_results(results, queue_count);
+    free_list(all_processes);
+}
+
+static void* batch_worker_main(void* arg) {
+    BatchWorker* worker = (BatchWorker*)arg;
+    BatchJob* job = worker->job;
+    
+    for (;;) {
+        pthread_mutex_lock(&job->lock);
+        int index = job->next_file++;
+        pthread_mutex_unlock(&job->lock);
+        
+        if (index >= job->file_count) break;
+        simulate_file(worker, index);
+    }
+    
+    return NULL;
+}
+
+static double elapsed_seconds(const struct timespec* start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static int append_block(FILE* output, const BatchBlock* block, char* buffer) {
+    if (!block->spool || block->length == 0) return 0;
+    
+    if (fseek(block->spool, block->offset, SEEK_SET) != 0) return -1;
+    long remaining = block->length;
+    while (remaining > 0) {
+        size_t chunk = remaining < BATCH_IO_BUFFER ? (size_t)remaining : BATCH_IO_BUFFER;
+        size_t n = fread(buffer, 1, chunk, block->spool);
+        if (n == 0 || fwrite(buffer, 1, n, output) != n) return -1;
+        remaining -= n;
+    }
+    return 0;
+}
+
+int run_batch(const BatchOptions* options) {
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    
+    struct stat info;
+    if (stat(options->source, &info) != 0) {
+        perror("Error opening batch source");
+        return EXIT_FAILURE;
+    }
+    
+    BatchJob job;
+    job.files = S_ISDIR(info.st_mode) ? list_directory(options->source, &job.file_count)
+                                      : read_manifest(options->source, &job.file_count);
+    if (check_destination(job.files, job.file_count, options) != 0) {
+        for (int i = 0; i < job.file_count; i++) {
+            free(job.files[i]);
+        }
+        free(job.files);
+        return EXIT_FAILURE;
+    }
+    
+    job.blocks = (BatchBlock*)calloc(job.file_count ? job.file_count : 1, sizeof(BatchBlock));
+    if (!job.blocks) {
+        perror("Failed to allocate batch blocks");
+        exit(EXIT_FAILURE);
+    }
+    job.next_file = 0;
+    job.options = options;
+    pthread_mutex_init(&job.lock, NULL);
+    
+    int jobs = options->jobs;
+    if (jobs < 1) jobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (jobs < 1) jobs = 1;
+    if (jobs > job.file_count && job.file_count > 0) jobs = job.file_count;
+    
+    /* Each worker may split a large queue again; share --threads among the
+     * workers instead of starting jobs * threads threads. */
+    int threads = get_parallel_threads();
+    set_parallel_threads(threads / jobs);
+    
+    printf("Batch: %d input files, %d workers\n", job.file_count, jobs);
+    
+    BatchWorker* workers = (BatchWorker*)calloc(jobs, sizeof(BatchWorker));
+    if (!workers) {
+        perror("Failed to allocate batch workers");
+        exit(EXIT_FAILURE);
+    }
+    
+    for (int w = 0; w < jobs; w++) {
+        workers[w].job = &job;
+        workers[w].read_buffer = (char*)malloc(BATCH_IO_BUFFER);
+        workers[w].write_buffer = (char*)malloc(BATCH_IO_BUFFER);
+        workers[w].spool = options->combined ? tmpfile() : NULL;
+        if (!workers[w].read_buffer || !workers[w].write_buffer ||
+            (options->combined && !workers[w].spool)) {
+            perror("Failed to allocate batch worker buffers");
+            exit(EXIT_FAILURE);
+        }
+        if (pthread_create(&workers[w].thread, NULL, batch_worker_main, &workers[w]) != 0) {
+            perror("Failed to start batch worker");
+            exit(EXIT_FAILURE);
+        }
+    }
+    
+    long files_done = 0, files_failed = 0, processes = 0;
+    for (int w = 0; w < jobs; w++) {
+        pthread_join(workers[w].thread, NULL);
+        files_done += workers[w].files_done;
+        files_failed += workers[w].files_failed;
+        processes += workers[w].processes;
+    }
+    
+    if (options->combined) {
+        FILE* output = fopen(options->destination, "w");
+        if (!output) {
+            perror("Error opening output file");
+            exit(EXIT_FAILURE);
+        }
+        int failed = 0;
+        for (int i = 0; i < job.file_count && !failed; i++) {
+            failed = append_block(output, &job.blocks[i], workers[0].read_buffer) != 0;
+        }
+        failed |= ferror(output);
+        if (fclose(output) != 0 || failed) {
+            fprintf(stderr, "Error writing %s\n", options->destination);
+            files_failed += files_done;
+            files_done = 0;
+            processes = 0;
+        }
+    }
+    
+    double seconds = elapsed_seconds(&start);
+    printf("Batch: %ld files simulated, %ld failed, %ld processes in %.3f s (%.1f files/s, %.0f processes/s)\n",
+           files_done, files_failed, processes, seconds,
+           seconds > 0 ? files_done / seconds : 0.0,
+           seconds > 0 ? processes / seconds : 0.0);
+    
+    for (int w = 0; w < jobs; w++) {
+        if (workers[w].spool) fclose(workers[w].spool);
+        free(workers[w].read_buffer);
+        free(workers[w].write_buffer);
+    }
+    free(workers);
+    
+    for (int i = 0; i < job.file_count; i++) {
+        free(job.files[i]);
+    }
+    free(job.files);
+    free(job.blocks);
+    pthread_mutex_destroy(&job.lock);
+    set_parallel_threads(threads);
+    
+    return files_failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,14 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+typedef struct {
+    const char* source;
+    const char* destination;
+    int combined;
+    int jobs;
+    int algorithms;
+} BatchOptions;
+
+int run_batch(const BatchOptions* options);
+
+#endif
@@ -0,0 +1,94 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "linked_list.h"
+#include "scheduler.h"
+#include "trace.h"
+
+#define BENCH_TRACE_FILE "bench_trace.bin"
+
+static volatile int sink;
+
+static ProcessList* make_queue(int count) {
+    ProcessList* list = create_list();
+    unsigned int state = 12345;
+    int arrival = 0;
+    
+    for (int i = 1; i <= count; i++) {
+        state = state * 1103515245u + 12345u;
+        arrival += (state >> 16) % 3;
+        add_process(list, create_process(i, 1 + (state >> 8) % 20, (state >> 4) % 8, arrival, 0));
+    }
+    
+    return list;
+}
+
+static double now_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e3 + now.tv_nsec / 1e6;
+}
+
+static double time_fcfs(ProcessList* queue, int rounds) {
+    double total = 0.0;
+    
+    for (int r = 0; r < rounds; r++) {
+        ProcessList* working = copy_list(queue);
+        double start = now_ms();
+        fcfs_schedule(working);
+        total += now_ms() - start;
+        free_list(working);
+    }
+    
+    return total / rounds;
+}
+
+/* The bare call-site cost: one TRACE_EVENT per iteration next to a store
+ * the compiler cannot drop. */
+static double time_events(int events, int rounds) {
+    double total = 0.0;
+    
+    for (int r = 0; r < rounds; r++) {
+        double start = now_ms();
+        for (int i = 0; i < events; i++) {
+            sink = i;
+            TRACE_EVENT(TRACE_DISPATCH, ALGORITHM_FCFS, 0, i, i, i + 1);
+        }
+        total += now_ms() - start;
+    }
+    
+    return total / rounds;
+}
+
+static void run_benchmarks(const char* label, ProcessList* queue, int count, int events, int rounds) {
+    double fcfs = time_fcfs(queue, rounds);
+    double loop = time_events(events, rounds);
+    printf("%-12s FCFS: %8.3f ms/run (%6.1f ns/process)   TRACE_EVENT loop: %6.2f ns/event\n",
+           label, fcfs, fcfs * 1e6 / count, loop * 1e6 / events);
+}
+
+int main(int argc, char* argv[]) {
+    int count = argc > 1 ? atoi(argv[1]) : 1000000;
+    int events = argc > 2 ? atoi(argv[2]) : 2000000;
+    int rounds = argc > 3 ? atoi(argv[3]) : 5;
+    ProcessList* queue = make_queue(count);
+    
+    printf("Tracing benchmark: %d-process FCFS queue, %d-event loop, %d rounds\n", count, events, rounds);
+    
+#ifdef NO_TRACE
+    run_benchmarks("compiled out", queue, count, events, rounds);
+#else
+    run_benchmarks("trace off", queue, count, events, rounds);
+    
+    if (trace_start(BENCH_TRACE_FILE) == 0) {
+        run_benchmarks("trace on", queue, count, events, rounds);
+        if (trace_stop() != 0) fprintf(stderr, "Warning: Trace file %s was not fully written\n", BENCH_TRACE_FILE);
+        remove(BENCH_TRACE_FILE);
+    }
+#endif
+    
+    free_list(queue);
+    return EXIT_SUCCESS;
+}
@@ -3,148 +3,247 @@
 #include <string.h>
 #include "linked_list.h"
 #include "scheduler.h"
+#include "simulation.h"
+#include "batch.h"
+#include "trace.h"
+#include "result_file.h"
+#include "queue_index.h"
+#include "pipeline.h"
+#include "parallel.h"
 #include "utils.h"
 
-void run_simulation(ProcessList* list, const char* output_filename);
-void write_results_to_file(const char* filename, ScheduleResult*** results, int queue_count);
-void write_results_to_screen(ScheduleResult*** results, int queue_count);
+static int compare_ints(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
 
-int main(int argc, char* argv[]) {
-    if (argc != 3) {
-        fprintf(stderr, "Usage: %s <input_file> <output_file>\n", argv[0]);
-        fprintf(stderr, "Example: ./cpe351 input.txt output.txt\n");
-        return EXIT_FAILURE;
+static int* parse_queue_ids(const char* text, int* count) {
+    int capacity = 1;
+    for (const char* c = text; *c; c++) {
+        if (*c == ',') capacity++;
     }
     
-    const char* input_file = argv[1];
-    const char* output_file = argv[2];
-    
-    printf("CPU Scheduler Simulator\n");
-    printf("=======================\n");
-    printf("Input file: %s\n", input_file);
-    printf("Output file: %s\n", output_file);
-    
-    ProcessList* all_processes = read_input_file(input_file);
-    printf("Read %d processes from input file.\n", all_processes->count);
-    
-    run_simulation(all_processes, output_file);
+    int* queue_ids = (int*)malloc(capacity * sizeof(int));
+    if (!queue_ids) {
+        perror("Failed to allocate queue filter");
+        exit(EXIT_FAILURE);
+    }
     
-    free_list(all_processes);
+    *count = 0;
+    const char* c = text;
+    while (*c) {
+        char* end;
+        long value = strtol(c, &end, 10);
+        if (end == c || (*end != ',' && *end != '\0')) {
+            free(queue_ids);
+            return NULL;
+        }
+        queue_ids[(*count)++] = (int)value;
+        c = *end ? end + 1 : end;
+    }
     
-    printf("\nSimulation completed successfully.\n");
-    return EXIT_SUCCESS;
+    qsort(queue_ids, *count, sizeof(int), compare_ints);
+    int unique = 0;
+    for (int i = 0; i < *count; i++) {
+        if (unique == 0 || queue_ids[i] != queue_ids[unique - 1]) queue_ids[unique++] = queue_ids[i];
+    }
+    *count = unique;
+    return queue_ids;
 }
 
-void run_simulation(ProcessList* all_processes, const char* output_filename) {
-    int queue_count;
-    ProcessList** queues = separate_by_queue(all_processes, &queue_count);
-    printf("Found %d queues.\n", queue_count);
-    
-    ScheduleResult*** all_results = (ScheduleResult***)malloc(queue_count * sizeof(ScheduleResult**));
-    if (!all_results) {
-        perror("Failed to allocate results array");
-        exit(EXIT_FAILURE);
+static int stop_tracing(const char* trace_file, const char* chrome_file, const char* gantt_file) {
+    if (trace_stop() != 0) {
+        fprintf(stderr, "Error writing trace file %s\n", trace_file);
+        return -1;
     }
+    printf("Trace written to %s\n", trace_file);
     
-    for (int q = 0; q < queue_count; q++) {
-        all_results[q] = (ScheduleResult**)malloc(3 * sizeof(ScheduleResult*));
-        if (!all_results[q]) {
-            perror("Failed to allocate queue results");
-            exit(EXIT_FAILURE);
+    int status = 0;
+    if (chrome_file) {
+        if (trace_export_chrome(trace_file, chrome_file) == 0) {
+            printf("Chrome trace written to %s\n", chrome_file);
+        } else {
+            status = -1;
         }
-        
-        for (int a = 0; a < 3; a++) {
-            all_results[q][a] = NULL;
+    }
+    if (gantt_file) {
+        if (trace_export_gantt(trace_file, gantt_file) == 0) {
+            printf("Gantt chart written to %s\n", gantt_file);
+        } else {
+            status = -1;
         }
-        
-        ProcessList* queue_list = queues[q];
-        if (!queue_list || queue_list->count == 0) {
-            for (int a = 0; a < 3; a++) {
-                all_results[q][a] = create_result(q, a + 1, queue_list);
+    }
+    return status;
+}
+
+static void print_usage(const char* program) {
+    fprintf(stderr, "Usage: %s <input_file> <output_file>\n", program);
+    fprintf(stderr, "       %s --batch <input_dir|manifest> <output_dir|output_file> [--combined] [--jobs N]\n", program);
+    fprintf(stderr, "       %s --dump-results <binary_results>\n", program);
+    fprintf(stderr, "       %s --build-index <input_file>\n", program);
+    fprintf(stderr, "Queues: [--queues 0,3,5] | [--pipeline [--jobs N]]\n");
+    fprintf(stderr, "Algorithms: [--algorithms fcfs,sjf,priority,ljf,hrrn,edf] (default fcfs,sjf,priority)\n");
+    fprintf(stderr, "Large queues: [--threads N]\n");
+    fprintf(stderr, "Output: [--format text|binary] [--summary-only]\n");
+    fprintf(stderr, "Tracing: [--trace trace.bin] [--chrome-trace trace.json] [--gantt gantt.txt]\n");
+    fprintf(stderr, "Example: ./cpe351 input.txt output.txt\n");
+}
+
+int main(int argc, char* argv[]) {
+    const char* positional[2];
+    int positional_count = 0;
+    int batch = 0;
+    BatchOptions batch_options = {NULL, NULL, 0, 0, ALGORITHMS_DEFAULT};
+    SimulationOptions options = {OUTPUT_TEXT, 0, ALGORITHMS_DEFAULT};
+    const char* dump_file = NULL;
+    int build_index = 0;
+    int pipeline = 0;
+    int* queue_ids = NULL;
+    int queue_id_count = 0;
+    const char* trace_file = NULL;
+    const char* chrome_file = NULL;
+    const char* gantt_file = NULL;
+    char default_trace_file[1024];
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--batch") == 0) {
+            batch = 1;
+        } else if (strcmp(argv[i], "--combined") == 0) {
+            batch_options.combined = 1;
+        } else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            batch_options.jobs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            const char* format = argv[++i];
+            if (strcmp(format, "binary") == 0) {
+                options.format = OUTPUT_BINARY;
+            } else if (strcmp(format, "text") != 0) {
+                print_usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--algorithms") == 0 && i + 1 < argc) {
+            options.algorithms = parse_algorithms(argv[++i]);
+            if (options.algorithms < 0) {
+                print_usage(argv[0]);
+                return EXIT_FAILURE;
             }
-            continue;
+            batch_options.algorithms = options.algorithms;
+        } else if (strcmp(argv[i], "--summary-only") == 0) {
+            options.summary_only = 1;
+        } else if (strcmp(argv[i], "--dump-results") == 0 && i + 1 < argc) {
+            dump_file = argv[++i];
+        } else if (strcmp(argv[i], "--build-index") == 0) {
+            build_index = 1;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            set_parallel_threads(atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--pipeline") == 0) {
+            pipeline = 1;
+        } else if (strcmp(argv[i], "--queues") == 0 && i + 1 < argc) {
+            free(queue_ids);
+            queue_ids = parse_queue_ids(argv[++i], &queue_id_count);
+            if (!queue_ids) {
+                print_usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_file = argv[++i];
+        } else if (strcmp(argv[i], "--chrome-trace") == 0 && i + 1 < argc) {
+            chrome_file = argv[++i];
+        } else if (strcmp(argv[i], "--gantt") == 0 && i + 1 < argc) {
+            gantt_file = argv[++i];
+        } else if (strncmp(argv[i], "--", 2) != 0 && positional_count < 2) {
+            positional[positional_count++] = argv[i];
+        } else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
         }
-        
-        printf("\nProcessing Queue %d (%d processes):\n", q, queue_list->count);
-        
-        printf("  Running FCFS... ");
-        ProcessList* fcfs_list = copy_list(queue_list);
-        fcfs_schedule(fcfs_list);
-        all_results[q][0] = create_result(q, 1, fcfs_list);
-        printf("Done. AWT: %.2f\n", all_results[q][0]->average_waiting);
-        free_list(fcfs_list);
-        
-        printf("  Running SJF... ");
-        ProcessList* sjf_list = copy_list(queue_list);
-        sjf_schedule(sjf_list);
-        all_results[q][1] = create_result(q, 2, sjf_list);
-        printf("Done. AWT: %.2f\n", all_results[q][1]->average_waiting);
-        free_list(sjf_list);
-        
-        printf("  Running Priority... ");
-        ProcessList* priority_list = copy_list(queue_list);
-        priority_schedule(priority_list);
-        all_results[q][2] = create_result(q, 3, priority_list);
-        printf("Done. AWT: %.2f\n", all_results[q][2]->average_waiting);
-        free_list(priority_list);
     }
     
-    write_results_to_file(output_filename, all_results, queue_count);
-    write_results_to_screen(all_results, queue_count);
+    if (dump_file) {
+        dump_result_file(dump_file);
+        return EXIT_SUCCESS;
+    }
+    
+    if (build_index && (positional_count != 1 || batch || pipeline || queue_ids)) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
     
-    for (int q = 0; q < queue_count; q++) {
-        if (queues[q]) free_list(queues[q]);
+    if (build_index) {
+        QueueIndex index;
+        build_queue_index(positional[0], &index);
         
-        for (int a = 0; a < 3; a++) {
-            if (all_results[q][a]) free_result(all_results[q][a]);
+        char index_file[4096];
+        queue_index_filename(positional[0], index_file, sizeof(index_file));
+        int status = save_queue_index(&index, index_file);
+        if (status == 0) {
+            printf("Indexed %d queues in %d ranges into %s\n", index.queue_count, index.range_count, index_file);
+        } else {
+            fprintf(stderr, "Error writing queue index %s\n", index_file);
         }
-        free(all_results[q]);
+        free_queue_index(&index);
+        return status == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
     }
-    free(all_results);
-    free(queues);
-}
-
-void write_results_to_file(const char* filename, ScheduleResult*** results, int queue_count) {
-    FILE* file = fopen(filename, "w");
-    if (!file) {
-        perror("Error opening output file");
-        exit(EXIT_FAILURE);
+    
+    if (positional_count != 2 || (pipeline && (queue_ids || batch))) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
     }
     
-    for (int q = 0; q < queue_count; q++) {
-        for (int a = 0; a < 3; a++) {
-            ScheduleResult* result = results[q][a];
-            if (!result) continue;
-            
-            fprintf(file, "%d:%d", result->queue_id, result->algorithm);
-            
-            for (int i = 0; i < result->process_count; i++) {
-                fprintf(file, ":%d", result->waiting_times[i]);
-            }
-            
-            fprintf(file, ":%.2f\n", result->average_waiting);
-        }
+    if (batch && (options.format != OUTPUT_TEXT || options.summary_only || queue_ids ||
+                  trace_file || chrome_file || gantt_file)) {
+        fprintf(stderr, "Error: --batch writes text results only and does not support "
+                        "--format, --summary-only, --queues or tracing\n");
+        return EXIT_FAILURE;
     }
     
-    fclose(file);
-    printf("\nResults written to %s\n", filename);
-}
-
-void write_results_to_screen(ScheduleResult*** results, int queue_count) {
-    printf("\nFinal Results:\n");
-    printf("==============\n");
-    
-    for (int q = 0; q < queue_count; q++) {
-        for (int a = 0; a < 3; a++) {
-            ScheduleResult* result = results[q][a];
-            if (!result) continue;
-            
-            printf("Queue %d, Algorithm %d: ", result->queue_id, result->algorithm);
-            for (int i = 0; i < result->process_count; i++) {
-                printf("%d", result->waiting_times[i]);
-                if (i < result->process_count - 1) printf(":");
-            }
-            printf(":%.2f\n", result->average_waiting);
-        }
+    if (batch) {
+        batch_options.source = positional[0];
+        batch_options.destination = positional[1];
+        return run_batch(&batch_options);
     }
+    
+    const char* input_file = positional[0];
+    const char* output_file = positional[1];
+    
+    printf("CPU Scheduler Simulator\n");
+    printf("=======================\n");
+    printf("Input file: %s\n", input_file);
+    printf("Output file: %s\n", output_file);
+    
+    if (!trace_file && (chrome_file || gantt_file)) {
+        snprintf(default_trace_file, sizeof(default_trace_file), "%s.trace", output_file);
+        trace_file = default_trace_file;
+    }
+    if (trace_file && trace_start(trace_file) != 0) {
+        return EXIT_FAILURE;
+    }
+    
+    if (pipeline) {
+        int status = run_pipeline(input_file, output_file, &options, batch_options.jobs);
+        if (trace_file && stop_tracing(trace_file, chrome_file, gantt_file) != 0) return EXIT_FAILURE;
+        printf("\nSimulation completed successfully.\n");
+        return status;
+    }
+    
+    ProcessList* all_processes;
+    if (queue_ids) {
+        QueueIndex index;
+        open_queue_index(input_file, &index);
+        all_processes = read_indexed_queues(input_file, &index, queue_ids, queue_id_count);
+        free_queue_index(&index);
+        free(queue_ids);
+    } else {
+        all_processes = read_input_file(input_file);
+    }
+    printf("Read %d processes from input file.\n", all_processes->count);
+    
+    run_simulation(all_processes, output_file, &options);
+    
+    free_list(all_processes);
+    
+    if (trace_file && stop_tracing(trace_file, chrome_file, gantt_file) != 0) return EXIT_FAILURE;
+    
+    printf("\nSimulation completed successfully.\n");
+    return EXIT_SUCCESS;
 }
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <limits.h>
 #include "linked_list.h"
 
 ProcessList* create_list() {
@@ -25,6 +26,7 @@ Process* create_process(int id, int burst, int priority, int arrival, int queue_
     p->priority = priority;
     p->arrival_time = arrival;
     p->queue_id = queue_id;
+    p->deadline = INT_MAX;
     p->waiting_time = 0;
     p->turnaround_time = 0;
     p->completion_time = 0;
@@ -101,6 +103,7 @@ ProcessList* copy_list(ProcessList* original) {
         Process* new_p = create_process(current->id, current->burst_time,
                                         current->priority, current->arrival_time,
                                         current->queue_id);
+        new_p->deadline = current->deadline;
         add_process(copy, new_p);
         current = current->next;
     }
@@ -191,41 +194,6 @@ void sort_by_priority(ProcessList* list) {
     } while (swapped);
 }
 
-Process* find_min_burst(ProcessList* list, int current_time) {
-    if (!list || !list->head) return NULL;
-    
-    Process* current = list->head;
-    Process* min_process = NULL;
-    int min_burst = 999999;
-    
-    while (current) {
-        if (current->arrival_time <= current_time && current->burst_time < min_burst) {
-            min_burst = current->burst_time;
-            min_process = current;
-        }
-        current = current->next;
-    }
-    
-    return min_process;
-}
-
-Process* find_highest_priority(ProcessList* list, int current_time) {
-    if (!list || !list->head) return NULL;
-    
-    Process* current = list->head;
-    Process* highest_process = NULL;
-    int highest_priority = 999999;
-    
-    while (current) {
-        if (current->arrival_time <= current_time && current->priority < highest_priority) {
-            highest_priority = current->priority;
-            highest_process = current;
-        }
-        current = current->next;
-    }
-    
-    return highest_process;
-}
 void print_list(ProcessList* list) {
     if (!list) {
         printf("List is NULL\n");
@@ -7,6 +7,7 @@ typedef struct Process {
     int priority;           
     int arrival_time;       
     int queue_id;           
+    int deadline;           
     int waiting_time;       
     int turnaround_time;    
     int completion_time;    
@@ -28,8 +29,6 @@ ProcessList* copy_list(ProcessList* original);
 void sort_by_arrival(ProcessList* list);
 void sort_by_burst(ProcessList* list);
 void sort_by_priority(ProcessList* list);
-Process* find_min_burst(ProcessList* list, int current_time);
-Process* find_highest_priority(ProcessList* list, int current_time);
 void print_list(ProcessList* list);
 
 #endif
@@ -0,0 +1,336 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "parallel.h"
+#include "linked_list.h"
+
+#define PARALLEL_MAX_THREADS 256
+#define INSERTION_RUN 32
+
+static int parallel_threads = 1;
+
+typedef struct {
+    ParallelBody body;
+    void* context;
+    int part;
+    int parts;
+} ParallelTask;
+
+void set_parallel_threads(int threads) {
+    if (threads < 1) threads = 1;
+    if (threads > PARALLEL_MAX_THREADS) threads = PARALLEL_MAX_THREADS;
+    parallel_threads = threads;
+}
+
+int get_parallel_threads(void) {
+    return parallel_threads;
+}
+
+int parallel_parts(int count) {
+    if (count < PARALLEL_MIN_ITEMS) return 1;
+    return parallel_threads;
+}
+
+static void* parallel_task_main(void* arg) {
+    ParallelTask* task = (ParallelTask*)arg;
+    task->body(task->context, task->part, task->parts);
+    return NULL;
+}
+
+/* Runs body(context, part, parts) for every part, part 0 on the calling thread. */
+void parallel_run(int parts, ParallelBody body, void* context) {
+    if (parts <= 1) {
+        body(context, 0, 1);
+        return;
+    }
+    
+    pthread_t threads[PARALLEL_MAX_THREADS];
+    ParallelTask tasks[PARALLEL_MAX_THREADS];
+    
+    for (int p = 1; p < parts; p++) {
+        tasks[p].body = body;
+        tasks[p].context = context;
+        tasks[p].part = p;
+        tasks[p].parts = parts;
+        if (pthread_create(&threads[p], NULL, parallel_task_main, &tasks[p]) != 0) {
+            perror("Failed to start parallel worker");
+            exit(EXIT_FAILURE);
+        }
+    }
+    
+    body(context, 0, parts);
+    
+    for (int p = 1; p < parts; p++) {
+        pthread_join(threads[p], NULL);
+    }
+}
+
+static long long part_begin(long long count, int part, int parts) {
+    return count * part / parts;
+}
+
+/* Stable merge of a[0..na) and b[0..nb) into out; ties keep a first. */
+static void merge_runs(Process** a, int na, Process** b, int nb, Process** out) {
+    int i = 0, j = 0, k = 0;
+    while (i < na && j < nb) {
+        out[k++] = (b[j]->arrival_time < a[i]->arrival_time) ? b[j++] : a[i++];
+    }
+    while (i < na) out[k++] = a[i++];
+    while (j < nb) out[k++] = b[j++];
+}
+
+static void sort_chunk(Process** items, Process** scratch, int count) {
+    for (int start = 0; start < count; start += INSERTION_RUN) {
+        int end = start + INSERTION_RUN < count ? start + INSERTION_RUN : count;
+        for (int i = start + 1; i < end; i++) {
+            Process* p = items[i];
+            int j = i - 1;
+            while (j >= start && items[j]->arrival_time > p->arrival_time) {
+                items[j + 1] = items[j];
+                j--;
+            }
+            items[j + 1] = p;
+        }
+    }
+    
+    Process** src = items;
+    Process** dst = scratch;
+    for (int width = INSERTION_RUN; width < count; width *= 2) {
+        for (int start = 0; start < count; start += 2 * width) {
+            int mid = start + width < count ? start + width : count;
+            int end = start + 2 * width < count ? start + 2 * width : count;
+            merge_runs(src + start, mid - start, src + mid, end - mid, dst + start);
+        }
+        Process** swap = src;
+        src = dst;
+        dst = swap;
+    }
+    
+    if (src != items) memcpy(items, src, count * sizeof(Process*));
+}
+
+/* Number of elements taken from a among the first d outputs of a stable merge. */
+static int co_rank(int d, Process** a, int na, Process** b, int nb) {
+    int lo = d > nb ? d - nb : 0;
+    int hi = d < na ? d : na;
+    
+    while (lo < hi) {
+        int i = lo + (hi - lo) / 2;
+        int j = d - i;
+        if (j > 0 && a[i]->arrival_time <= b[j - 1]->arrival_time) {
+            lo = i + 1;
+        } else {
+            hi = i;
+        }
+    }
+    return lo;
+}
+
+typedef struct {
+    Process** src;
+    Process** dst;
+    int count;
+    int width;
+    int chunks;
+} SortContext;
+
+static int chunk_bound(const SortContext* sort, int chunk) {
+    if (chunk > sort->chunks) chunk = sort->chunks;
+    return (int)part_begin(sort->count, chunk, sort->chunks);
+}
+
+static void sort_chunks_body(void* context, int part, int parts) {
+    SortContext* sort = (SortContext*)context;
+    int begin = (int)part_begin(sort->count, part, parts);
+    int end = (int)part_begin(sort->count, part + 1, parts);
+    sort_chunk(sort->src + begin, sort->dst + begin, end - begin);
+}
+
+/* Each part merges its own slice of the output, located with co_rank, for
+ * every pair of runs it overlaps, so even the final merge is spread out. */
+static void merge_round_body(void* context, int part, int parts) {
+    SortContext* sort = (SortContext*)context;
+    int lo = (int)part_begin(sort->count, part, parts);
+    int hi = (int)part_begin(sort->count, part + 1, parts);
+    
+    for (int chunk = 0; chunk < sort->chunks; chunk += 2 * sort->width) {
+        int start = chunk_bound(sort, chunk);
+        int mid = chunk_bound(sort, chunk + sort->width);
+        int end = chunk_bound(sort, chunk + 2 * sort->width);
+        
+        int s = lo > start ? lo : start;
+        int e = hi < end ? hi : end;
+        if (s >= e) continue;
+        
+        Process** a = sort->src + start;
+        Process** b = sort->src + mid;
+        int na = mid - start;
+        int nb = end - mid;
+        int ia0 = co_rank(s - start, a, na, b, nb);
+        int ia1 = co_rank(e - start, a, na, b, nb);
+        int ib0 = (s - start) - ia0;
+        int ib1 = (e - start) - ia1;
+        
+        merge_runs(a + ia0, ia1 - ia0, b + ib0, ib1 - ib0, sort->dst + s);
+    }
+}
+
+void parallel_sort_by_arrival(Process** items, int count) {
+    if (count < 2) return;
+    
+    Process** scratch = (Process**)malloc(count * sizeof(Process*));
+    if (!scratch) {
+        perror("Failed to allocate sort buffer");
+        exit(EXIT_FAILURE);
+    }
+    
+    int parts = parallel_parts(count);
+    SortContext sort = {items, scratch, count, 1, parts};
+    parallel_run(parts, sort_chunks_body, &sort);
+    
+    for (sort.width = 1; sort.width < parts; sort.width *= 2) {
+        parallel_run(parts, merge_round_body, &sort);
+        Process** swap = sort.src;
+        sort.src = sort.dst;
+        sort.dst = swap;
+    }
+    
+    if (sort.src != items) memcpy(items, sort.src, count * sizeof(Process*));
+    free(scratch);
+}
+
+/*
+ * FCFS completion times as a max-plus prefix scan: process i maps the time
+ * the CPU frees up, x, to max(x + burst, arrival + burst). Such maps compose
+ * to max(x + B, A), so each part summarizes its slice as one (B, A) pair,
+ * the pairs are folded serially, and each part then replays its slice from
+ * the exact start time.
+ */
+typedef struct {
+    long long shift;
+    long long floor;
+} MaxPlus;
+
+typedef struct {
+    Process** ordered;
+    int count;
+    MaxPlus summaries[PARALLEL_MAX_THREADS];
+    long long starts[PARALLEL_MAX_THREADS];
+} FcfsContext;
+
+static void fcfs_summary_body(void* context, int part, int parts) {
+    FcfsContext* fcfs = (FcfsContext*)context;
+    int begin = (int)part_begin(fcfs->count, part, parts);
+    int end = (int)part_begin(fcfs->count, part + 1, parts);
+    MaxPlus f = {0, 0};
+    
+    for (int i = begin; i < end; i++) {
+        long long burst = fcfs->ordered[i]->burst_time;
+        long long floor = (long long)fcfs->ordered[i]->arrival_time + burst;
+        f.floor = f.floor + burst > floor ? f.floor + burst : floor;
+        f.shift += burst;
+    }
+    
+    fcfs->summaries[part] = f;
+}
+
+static void fcfs_replay_body(void* context, int part, int parts) {
+    FcfsContext* fcfs = (FcfsContext*)context;
+    int begin = (int)part_begin(fcfs->count, part, parts);
+    int end = (int)part_begin(fcfs->count, part + 1, parts);
+    long long current_time = fcfs->starts[part];
+    
+    for (int i = begin; i < end; i++) {
+        Process* p = fcfs->ordered[i];
+        if (p->arrival_time > current_time) current_time = p->arrival_time;
+        
+        p->waiting_time = (int)(current_time - p->arrival_time);
+        p->completion_time = (int)(current_time + p->burst_time);
+        p->turnaround_time = p->completion_time - p->arrival_time;
+        current_time += p->burst_time;
+    }
+}
+
+void parallel_fcfs_times(Process** ordered, int count) {
+    if (count < 1) return;
+    
+    FcfsContext* fcfs = (FcfsContext*)malloc(sizeof(FcfsContext));
+    if (!fcfs) {
+        perror("Failed to allocate FCFS scan");
+        exit(EXIT_FAILURE);
+    }
+    fcfs->ordered = ordered;
+    fcfs->count = count;
+    
+    int parts = parallel_parts(count);
+    fcfs->starts[0] = 0;
+    if (parts > 1) {
+        parallel_run(parts, fcfs_summary_body, fcfs);
+        for (int p = 1; p < parts; p++) {
+            MaxPlus f = fcfs->summaries[p - 1];
+            long long shifted = fcfs->starts[p - 1] + f.shift;
+            fcfs->starts[p] = shifted > f.floor ? shifted : f.floor;
+        }
+    }
+    parallel_run(parts, fcfs_replay_body, fcfs);
+    
+    free(fcfs);
+}
+
+typedef struct {
+    Process** items;
+    int count;
+    int* waiting;
+    int* turnaround;
+    int* completion;
+    MetricTotals partials[PARALLEL_MAX_THREADS];
+} MetricsContext;
+
+static void metrics_body(void* context, int part, int parts) {
+    MetricsContext* metrics = (MetricsContext*)context;
+    int begin = (int)part_begin(metrics->count, part, parts);
+    int end = (int)part_begin(metrics->count, part + 1, parts);
+    MetricTotals totals = {0, 0, 0, 0};
+    
+    for (int i = begin; i < end; i++) {
+        Process* p = metrics->items[i];
+        if (metrics->waiting) metrics->waiting[i] = p->waiting_time;
+        if (metrics->turnaround) metrics->turnaround[i] = p->turnaround_time;
+        if (metrics->completion) metrics->completion[i] = p->completion_time;
+        totals.total_waiting += p->waiting_time;
+        totals.total_turnaround += p->turnaround_time;
+        if (p->waiting_time > totals.max_waiting) totals.max_waiting = p->waiting_time;
+        if (p->completion_time > totals.makespan) totals.makespan = p->completion_time;
+    }
+    
+    metrics->partials[part] = totals;
+}
+
+void parallel_collect_metrics(Process** items, int count, int* waiting, int* turnaround,
+                              int* completion, MetricTotals* totals) {
+    MetricsContext* metrics = (MetricsContext*)malloc(sizeof(MetricsContext));
+    if (!metrics) {
+        perror("Failed to allocate metric reduction");
+        exit(EXIT_FAILURE);
+    }
+    metrics->items = items;
+    metrics->count = count;
+    metrics->waiting = waiting;
+    metrics->turnaround = turnaround;
+    metrics->completion = completion;
+    
+    int parts = parallel_parts(count);
+    parallel_run(parts, metrics_body, metrics);
+    
+    MetricTotals result = {0, 0, 0, 0};
+    for (int p = 0; p < parts; p++) {
+        result.total_waiting += metrics->partials[p].total_waiting;
+        result.total_turnaround += metrics->partials[p].total_turnaround;
+        if (metrics->partials[p].max_waiting > result.max_waiting) result.max_waiting = metrics->partials[p].max_waiting;
+        if (metrics->partials[p].makespan > result.makespan) result.makespan = metrics->partials[p].makespan;
+    }
+    *totals = result;
+    
+    free(metrics);
+}
@@ -0,0 +1,27 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include "linked_list.h"
+
+#define PARALLEL_MIN_ITEMS 65536
+
+typedef struct {
+    long long total_waiting;
+    long long total_turnaround;
+    int max_waiting;
+    int makespan;
+} MetricTotals;
+
+typedef void (*ParallelBody)(void* context, int part, int parts);
+
+void set_parallel_threads(int threads);
+int get_parallel_threads(void);
+int parallel_parts(int count);
+void parallel_run(int parts, ParallelBody body, void* context);
+
+void parallel_sort_by_arrival(Process** items, int count);
+void parallel_fcfs_times(Process** ordered, int count);
+void parallel_collect_metrics(Process** items, int count, int* waiting, int* turnaround,
+                              int* completion, MetricTotals* totals);
+
+#endif
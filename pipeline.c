@@ -0,0 +1,445 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include "pipeline.h"
+#include "linked_list.h"
+#include "scheduler.h"
+#include "simulation.h"
+#include "queue_index.h"
+#include "result_file.h"
+#include "parallel.h"
+#include "utils.h"
+
+#define PIPELINE_QUEUE_SIZE 64
+#define PIPELINE_IO_BUFFER (64 * 1024)
+
+/* Bounded multi-producer/multi-consumer ring; each cell's sequence number
+ * tells producers and consumers whose turn it is, so no locks are taken. */
+typedef struct {
+    uint64_t sequence;
+    void* value;
+} PipelineCell;
+
+typedef struct {
+    PipelineCell cells[PIPELINE_QUEUE_SIZE];
+    char pad0[64];
+    uint64_t enqueue_pos;
+    char pad1[64];
+    uint64_t dequeue_pos;
+} PipelineQueue;
+
+typedef struct {
+    int queue_id;
+    ProcessList* list;
+    ScheduleResult** results;
+} PipelineItem;
+
+typedef struct {
+    PipelineQueue tasks;
+    PipelineQueue done;
+    int queue_count;
+    int detail;
+    const SimulationOptions* options;
+    const char* output_filename;
+    long processes;
+} Pipeline;
+
+static void pipeline_queue_init(PipelineQueue* queue) {
+    for (uint64_t i = 0; i < PIPELINE_QUEUE_SIZE; i++) {
+        queue->cells[i].sequence = i;
+        queue->cells[i].value = NULL;
+    }
+    queue->enqueue_pos = 0;
+    queue->dequeue_pos = 0;
+}
+
+static void backoff(int* spins) {
+    if (++(*spins) < 64) {
+        sched_yield();
+    } else {
+        struct timespec pause = {0, 50000};
+        nanosleep(&pause, NULL);
+    }
+}
+
+static void pipeline_push(PipelineQueue* queue, void* value) {
+    int spins = 0;
+    uint64_t pos = __atomic_load_n(&queue->enqueue_pos, __ATOMIC_RELAXED);
+    
+    for (;;) {
+        PipelineCell* cell = &queue->cells[pos % PIPELINE_QUEUE_SIZE];
+        uint64_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        int64_t diff = (int64_t)(sequence - pos);
+        
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&queue->enqueue_pos, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                cell->value = value;
+                __atomic_store_n(&cell->sequence, pos + 1, __ATOMIC_RELEASE);
+                return;
+            }
+        } else if (diff < 0) {
+            backoff(&spins);
+            pos = __atomic_load_n(&queue->enqueue_pos, __ATOMIC_RELAXED);
+        } else {
+            pos = __atomic_load_n(&queue->enqueue_pos, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static void* pipeline_pop(PipelineQueue* queue) {
+    int spins = 0;
+    uint64_t pos = __atomic_load_n(&queue->dequeue_pos, __ATOMIC_RELAXED);
+    
+    for (;;) {
+        PipelineCell* cell = &queue->cells[pos % PIPELINE_QUEUE_SIZE];
+        uint64_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        int64_t diff = (int64_t)(sequence - (pos + 1));
+        
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&queue->dequeue_pos, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                void* value = cell->value;
+                __atomic_store_n(&cell->sequence, pos + PIPELINE_QUEUE_SIZE, __ATOMIC_RELEASE);
+                return value;
+            }
+        } else if (diff < 0) {
+            backoff(&spins);
+            pos = __atomic_load_n(&queue->dequeue_pos, __ATOMIC_RELAXED);
+        } else {
+            pos = __atomic_load_n(&queue->dequeue_pos, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static void dispatch_queue(Pipeline* pipeline, int queue_id, ProcessList* list) {
+    PipelineItem* item = (PipelineItem*)malloc(sizeof(PipelineItem));
+    if (!item) {
+        perror("Failed to allocate pipeline item");
+        exit(EXIT_FAILURE);
+    }
+    item->queue_id = queue_id;
+    item->list = list;
+    item->results = NULL;
+    pipeline_push(&pipeline->tasks, item);
+}
+
+static int compare_end_offsets(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+/* Parses the trace in one pass and hands each queue to the workers as soon
+ * as the reader moves past the last line the index recorded for it. */
+static void read_and_dispatch(Pipeline* pipeline, const char* input_filename, const QueueIndex* index) {
+    int queue_count = pipeline->queue_count;
+    ProcessList** queues = (ProcessList**)malloc(queue_count * sizeof(ProcessList*));
+    uint64_t* ends = (uint64_t*)malloc(queue_count * 2 * sizeof(uint64_t));
+    if ((!queues || !ends) && queue_count > 0) {
+        perror("Failed to allocate pipeline queues");
+        exit(EXIT_FAILURE);
+    }
+    
+    int pending = 0;
+    for (int q = 0; q < queue_count; q++) {
+        uint64_t end = queue_end_offset(index, q);
+        queues[q] = NULL;
+        if (end == 0) {
+            dispatch_queue(pipeline, q, NULL);
+        } else {
+            queues[q] = create_list();
+            ends[2 * pending] = end;
+            ends[2 * pending + 1] = (uint64_t)q;
+            pending++;
+        }
+    }
+    qsort(ends, pending, 2 * sizeof(uint64_t), compare_end_offsets);
+    
+    FILE* file = fopen(input_filename, "r");
+    if (!file) {
+        perror("Error opening input file");
+        exit(EXIT_FAILURE);
+    }
+    char* read_buffer = (char*)malloc(PIPELINE_IO_BUFFER);
+    if (read_buffer) setvbuf(file, read_buffer, _IOFBF, PIPELINE_IO_BUFFER);
+    
+    char line[256];
+    uint64_t offset = 0;
+    int process_id = 1;
+    int next_end = 0;
+    
+    while (next_end < pending && fgets(line, sizeof(line), file)) {
+        offset += strlen(line);
+        
+        Process* p = parse_process_line(line, process_id, 1);
+        if (p) {
+            process_id++;
+            if (p->queue_id < 0) {
+                free(p);
+            } else if (p->queue_id < queue_count && queues[p->queue_id]) {
+                add_process(queues[p->queue_id], p);
+            } else {
+                /* The queue is unknown or was already handed off, so the
+                 * index no longer describes this file. */
+                fprintf(stderr, "Error: Queue index does not match input file\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        
+        while (next_end < pending && ends[2 * next_end] <= offset) {
+            int q = (int)ends[2 * next_end + 1];
+            pipeline->processes += queues[q]->count;
+            dispatch_queue(pipeline, q, queues[q]);
+            queues[q] = NULL;
+            next_end++;
+        }
+    }
+    
+    if (next_end < pending) {
+        fprintf(stderr, "Error: Queue index does not match input file\n");
+        exit(EXIT_FAILURE);
+    }
+    
+    fclose(file);
+    free(read_buffer);
+    free(queues);
+    free(ends);
+}
+
+/* Without a usable index no queue is known to be complete until EOF, so
+ * this pass only collects the queues and records the index for next time. */
+static ProcessList** read_and_index(Pipeline* pipeline, const char* input_filename, QueueIndex* index) {
+    FILE* file = fopen(input_filename, "r");
+    if (!file) {
+        perror("Error opening input file");
+        exit(EXIT_FAILURE);
+    }
+    char* read_buffer = (char*)malloc(PIPELINE_IO_BUFFER);
+    if (read_buffer) setvbuf(file, read_buffer, _IOFBF, PIPELINE_IO_BUFFER);
+    
+    begin_queue_index(input_filename, index);
+    
+    ProcessList** queues = NULL;
+    int capacity = 0;
+    char line[256];
+    uint64_t offset = 0;
+    int process_id = 1;
+    
+    while (fgets(line, sizeof(line), file)) {
+        uint64_t length = strlen(line);
+        
+        Process* p = parse_process_line(line, process_id, 1);
+        if (p) {
+            if (p->queue_id >= 0) {
+                index_queue_line(index, offset, length, p->queue_id, process_id);
+                if (p->queue_id >= capacity) {
+                    int grown = capacity ? capacity : 16;
+                    while (grown <= p->queue_id) grown *= 2;
+                    queues = (ProcessList**)realloc(queues, grown * sizeof(ProcessList*));
+                    if (!queues) {
+                        perror("Failed to grow pipeline queues");
+                        exit(EXIT_FAILURE);
+                    }
+                    memset(queues + capacity, 0, (grown - capacity) * sizeof(ProcessList*));
+                    capacity = grown;
+                }
+                if (!queues[p->queue_id]) queues[p->queue_id] = create_list();
+                add_process(queues[p->queue_id], p);
+                pipeline->processes++;
+            } else {
+                free(p);
+            }
+            process_id++;
+        }
+        
+        offset += length;
+    }
+    
+    fclose(file);
+    free(read_buffer);
+    finish_queue_index(index);
+    return queues;
+}
+
+static void* worker_main(void* arg) {
+    Pipeline* pipeline = (Pipeline*)arg;
+    
+    for (;;) {
+        PipelineItem* item = (PipelineItem*)pipeline_pop(&pipeline->tasks);
+        if (!item) break;
+        
+        item->results = schedule_queue(item->queue_id, item->list, pipeline->detail,
+                                       pipeline->options->algorithms, 0);
+        if (item->list) free_list(item->list);
+        item->list = NULL;
+        
+        pipeline_push(&pipeline->done, item);
+    }
+    
+    return NULL;
+}
+
+static void emit_queue(FILE* text, ResultFileWriter* binary, ScheduleResult** results) {
+    if (text) {
+        write_queue_results(text, results);
+    } else {
+        for (int a = 0; a < ALGORITHM_COUNT; a++) {
+            result_writer_add(binary, results[a]);
+        }
+    }
+    
+    for (int a = 0; a < ALGORITHM_COUNT; a++) {
+        if (results[a]) print_result(results[a]);
+    }
+}
+
+/* Writes queue q as soon as queues 0..q have all finished, keeping output
+ * order identical to the sequential path. */
+static void* writer_main(void* arg) {
+    Pipeline* pipeline = (Pipeline*)arg;
+    FILE* text = NULL;
+    ResultFileWriter binary;
+    
+    if (pipeline->options->format == OUTPUT_BINARY) {
+        if (result_writer_open(&binary, pipeline->output_filename) != 0) exit(EXIT_FAILURE);
+    } else {
+        text = fopen(pipeline->output_filename, "w");
+        if (!text) {
+            perror("Error opening output file");
+            exit(EXIT_FAILURE);
+        }
+    }
+    
+    ScheduleResult*** finished = (ScheduleResult***)calloc(pipeline->queue_count + 1, sizeof(ScheduleResult**));
+    if (!finished) {
+        perror("Failed to allocate pipeline results");
+        exit(EXIT_FAILURE);
+    }
+    
+    printf("\nFinal Results:\n");
+    printf("==============\n");
+    
+    int next = 0;
+    while (next < pipeline->queue_count) {
+        PipelineItem* item = (PipelineItem*)pipeline_pop(&pipeline->done);
+        finished[item->queue_id] = item->results;
+        free(item);
+        
+        while (next < pipeline->queue_count && finished[next]) {
+            emit_queue(text, &binary, finished[next]);
+            free_queue_results(finished[next]);
+            finished[next] = NULL;
+            next++;
+        }
+    }
+    
+    free(finished);
+    if (text) {
+        int failed = ferror(text);
+        if (fclose(text) != 0 || failed) {
+            fprintf(stderr, "Error writing %s\n", pipeline->output_filename);
+            exit(EXIT_FAILURE);
+        }
+    } else if (result_writer_close(&binary) != 0) {
+        fprintf(stderr, "Error writing %s\n", pipeline->output_filename);
+        exit(EXIT_FAILURE);
+    }
+    
+    return NULL;
+}
+
+static void start_writer(Pipeline* pipeline, pthread_t* writer) {
+    if (pthread_create(writer, NULL, writer_main, pipeline) != 0) {
+        perror("Failed to start pipeline writer");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/* The hand-off rings hold at most PIPELINE_QUEUE_SIZE items each, but the
+ * reader's open lists and the writer's reorder table are not bounded: they
+ * hold every queue the trace interleaves with, or finishes ahead of, the
+ * next queue to be written. Blocking either of them could deadlock on a
+ * queue that is still being read. */
+int run_pipeline(const char* input_filename, const char* output_filename,
+                 const SimulationOptions* options, int workers) {
+    QueueIndex index;
+    char index_filename[4096];
+    queue_index_filename(input_filename, index_filename, sizeof(index_filename));
+    int indexed = load_queue_index(&index, index_filename, input_filename) == 0;
+    
+    if (workers < 1) workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (workers < 1) workers = 1;
+    
+    /* Scheduler workers share --threads for splitting large queues. */
+    int parallel_threads = get_parallel_threads();
+    set_parallel_threads(parallel_threads / workers);
+    
+    Pipeline* pipeline = (Pipeline*)malloc(sizeof(Pipeline));
+    pthread_t* threads = (pthread_t*)malloc(workers * sizeof(pthread_t));
+    if (!pipeline || !threads) {
+        perror("Failed to allocate pipeline");
+        exit(EXIT_FAILURE);
+    }
+    
+    pipeline_queue_init(&pipeline->tasks);
+    pipeline_queue_init(&pipeline->done);
+    pipeline->queue_count = indexed ? index.queue_count : 0;
+    pipeline->detail = result_detail(options);
+    pipeline->options = options;
+    pipeline->output_filename = output_filename;
+    pipeline->processes = 0;
+    
+    if (indexed) {
+        printf("Pipelined run: %d queues, %d scheduler workers\n", pipeline->queue_count, workers);
+    } else {
+        printf("Pipelined run: indexing %s while reading, %d scheduler workers\n", index_filename, workers);
+    }
+    
+    for (int w = 0; w < workers; w++) {
+        if (pthread_create(&threads[w], NULL, worker_main, pipeline) != 0) {
+            perror("Failed to start pipeline worker");
+            exit(EXIT_FAILURE);
+        }
+    }
+    
+    pthread_t writer;
+    if (indexed) {
+        start_writer(pipeline, &writer);
+        read_and_dispatch(pipeline, input_filename, &index);
+    } else {
+        ProcessList** queues = read_and_index(pipeline, input_filename, &index);
+        pipeline->queue_count = index.queue_count;
+        start_writer(pipeline, &writer);
+        for (int q = 0; q < pipeline->queue_count; q++) {
+            dispatch_queue(pipeline, q, queues[q]);
+        }
+        free(queues);
+        
+        if (save_queue_index(&index, index_filename) != 0) {
+            fprintf(stderr, "Warning: Could not write queue index %s\n", index_filename);
+        }
+    }
+    
+    for (int w = 0; w < workers; w++) {
+        pipeline_push(&pipeline->tasks, NULL);
+    }
+    for (int w = 0; w < workers; w++) {
+        pthread_join(threads[w], NULL);
+    }
+    pthread_join(writer, NULL);
+    
+    printf("\nRead %ld processes; results written to %s\n", pipeline->processes, output_filename);
+    
+    free_queue_index(&index);
+    free(threads);
+    free(pipeline);
+    set_parallel_threads(parallel_threads);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,9 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "simulation.h"
+
+int run_pipeline(const char* input_filename, const char* output_filename,
+                 const SimulationOptions* options, int workers);
+
+#endif
@@ -0,0 +1,293 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "queue_index.h"
+#include "linked_list.h"
+#include "utils.h"
+
+#define QUEUE_INDEX_MAGIC "CPEQIX2"
+#define QUEUE_INDEX_SUFFIX ".qidx"
+
+typedef struct {
+    char magic[8];
+    uint64_t source_size;
+    int64_t source_mtime;
+    int64_t source_mtime_nsec;
+    uint64_t source_inode;
+    int32_t queue_count;
+    int32_t range_count;
+} QueueIndexHeader;
+
+static void* allocate(size_t size, const char* what) {
+    void* memory = malloc(size ? size : 1);
+    if (!memory) {
+        perror(what);
+        exit(EXIT_FAILURE);
+    }
+    return memory;
+}
+
+/* Size, nanosecond mtime and inode; a trace rewritten within the same
+ * second at the same size still invalidates its index. */
+static void stat_trace(const char* trace_filename, QueueIndex* index) {
+    struct stat info;
+    if (stat(trace_filename, &info) != 0) {
+        perror("Error opening input file");
+        exit(EXIT_FAILURE);
+    }
+    index->source_size = info.st_size;
+    index->source_mtime = info.st_mtim.tv_sec;
+    index->source_mtime_nsec = info.st_mtim.tv_nsec;
+    index->source_inode = info.st_ino;
+}
+
+void queue_index_filename(const char* trace_filename, char* buffer, size_t size) {
+    snprintf(buffer, size, "%s%s", trace_filename, QUEUE_INDEX_SUFFIX);
+}
+
+static void group_ranges_by_queue(QueueIndex* index) {
+    int* counts = (int*)calloc(index->queue_count + 1, sizeof(int));
+    QueueRange* grouped = (QueueRange*)allocate(index->range_count * sizeof(QueueRange), "Failed to allocate queue index");
+    if (!counts) {
+        perror("Failed to allocate queue index");
+        exit(EXIT_FAILURE);
+    }
+    
+    for (int r = 0; r < index->range_count; r++) {
+        counts[index->ranges[r].queue_id + 1]++;
+    }
+    for (int q = 0; q < index->queue_count; q++) {
+        counts[q + 1] += counts[q];
+    }
+    
+    index->first_range = (int*)allocate((index->queue_count + 1) * sizeof(int), "Failed to allocate queue index");
+    memcpy(index->first_range, counts, (index->queue_count + 1) * sizeof(int));
+    
+    for (int r = 0; r < index->range_count; r++) {
+        grouped[counts[index->ranges[r].queue_id]++] = index->ranges[r];
+    }
+    
+    free(index->ranges);
+    free(counts);
+    index->ranges = grouped;
+}
+
+void begin_queue_index(const char* trace_filename, QueueIndex* index) {
+    stat_trace(trace_filename, index);
+    index->queue_count = 0;
+    index->range_count = 0;
+    index->range_capacity = 1024;
+    index->ranges = (QueueRange*)allocate(index->range_capacity * sizeof(QueueRange), "Failed to allocate queue index");
+    index->first_range = NULL;
+}
+
+/* Extends the previous range when this line directly follows it in the same
+ * queue; any other line in between (invalid or another queue) starts a new one. */
+void index_queue_line(QueueIndex* index, uint64_t offset, uint64_t length, int queue_id, int process_id) {
+    QueueRange* run = index->range_count > 0 ? &index->ranges[index->range_count - 1] : NULL;
+    
+    if (run && run->queue_id == queue_id && run->offset + run->length == offset) {
+        run->length += length;
+    } else {
+        if (index->range_count == index->range_capacity) {
+            index->range_capacity *= 2;
+            index->ranges = (QueueRange*)realloc(index->ranges, index->range_capacity * sizeof(QueueRange));
+            if (!index->ranges) {
+                perror("Failed to grow queue index");
+                exit(EXIT_FAILURE);
+            }
+        }
+        run = &index->ranges[index->range_count++];
+        run->offset = offset;
+        run->length = length;
+        run->queue_id = queue_id;
+        run->first_id = process_id;
+    }
+    if (queue_id >= index->queue_count) index->queue_count = queue_id + 1;
+}
+
+void finish_queue_index(QueueIndex* index) {
+    group_ranges_by_queue(index);
+}
+
+void build_queue_index(const char* trace_filename, QueueIndex* index) {
+    FILE* file = fopen(trace_filename, "r");
+    if (!file) {
+        perror("Error opening input file");
+        exit(EXIT_FAILURE);
+    }
+    
+    begin_queue_index(trace_filename, index);
+    
+    char line[256];
+    uint64_t offset = 0;
+    int process_id = 1;
+    
+    while (fgets(line, sizeof(line), file)) {
+        uint64_t length = strlen(line);
+        Process* p = parse_process_line(line, process_id, 0);
+        
+        if (p) {
+            if (p->queue_id >= 0) index_queue_line(index, offset, length, p->queue_id, process_id);
+            process_id++;
+            free(p);
+        }
+        
+        offset += length;
+    }
+    
+    fclose(file);
+    finish_queue_index(index);
+}
+
+int save_queue_index(const QueueIndex* index, const char* index_filename) {
+    FILE* file = fopen(index_filename, "wb");
+    if (!file) return -1;
+    
+    QueueIndexHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, QUEUE_INDEX_MAGIC, sizeof(QUEUE_INDEX_MAGIC));
+    header.source_size = index->source_size;
+    header.source_mtime = index->source_mtime;
+    header.source_mtime_nsec = index->source_mtime_nsec;
+    header.source_inode = index->source_inode;
+    header.queue_count = index->queue_count;
+    header.range_count = index->range_count;
+    
+    int ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+             fwrite(index->ranges, sizeof(QueueRange), index->range_count, file) == (size_t)index->range_count;
+    
+    if (fclose(file) != 0) ok = 0;
+    if (!ok) remove(index_filename);
+    return ok ? 0 : -1;
+}
+
+static int range_is_valid(const QueueRange* range, const QueueIndex* index) {
+    return range->queue_id >= 0 && range->queue_id < index->queue_count &&
+           range->length > 0 && range->first_id > 0 &&
+           range->offset <= index->source_size &&
+           range->length <= index->source_size - range->offset;
+}
+
+int load_queue_index(QueueIndex* index, const char* index_filename, const char* trace_filename) {
+    FILE* file = fopen(index_filename, "rb");
+    if (!file) return -1;
+    
+    stat_trace(trace_filename, index);
+    
+    QueueIndexHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, QUEUE_INDEX_MAGIC, sizeof(QUEUE_INDEX_MAGIC)) != 0 ||
+        header.source_size != index->source_size ||
+        header.source_mtime != index->source_mtime ||
+        header.source_mtime_nsec != index->source_mtime_nsec ||
+        header.source_inode != index->source_inode ||
+        header.queue_count < 0 || header.range_count < 0) {
+        fclose(file);
+        return -1;
+    }
+    
+    index->queue_count = header.queue_count;
+    index->range_count = header.range_count;
+    index->range_capacity = header.range_count;
+    index->ranges = (QueueRange*)allocate(header.range_count * sizeof(QueueRange), "Failed to allocate queue index");
+    
+    int ok = fread(index->ranges, sizeof(QueueRange), header.range_count, file) == (size_t)header.range_count;
+    for (int r = 0; ok && r < index->range_count; r++) {
+        ok = range_is_valid(&index->ranges[r], index);
+    }
+    fclose(file);
+    
+    if (!ok) {
+        fprintf(stderr, "Warning: Ignoring corrupt queue index %s\n", index_filename);
+        free(index->ranges);
+        index->ranges = NULL;
+        return -1;
+    }
+    
+    group_ranges_by_queue(index);
+    return 0;
+}
+
+void open_queue_index(const char* trace_filename, QueueIndex* index) {
+    char index_filename[4096];
+    queue_index_filename(trace_filename, index_filename, sizeof(index_filename));
+    
+    if (load_queue_index(index, index_filename, trace_filename) == 0) return;
+    
+    printf("Building queue index %s\n", index_filename);
+    build_queue_index(trace_filename, index);
+    if (save_queue_index(index, index_filename) != 0) {
+        fprintf(stderr, "Warning: Could not write queue index %s\n", index_filename);
+    }
+}
+
+void free_queue_index(QueueIndex* index) {
+    free(index->ranges);
+    free(index->first_range);
+    index->ranges = NULL;
+    index->first_range = NULL;
+}
+
+uint64_t queue_end_offset(const QueueIndex* index, int queue_id) {
+    if (queue_id < 0 || queue_id >= index->queue_count) return 0;
+    
+    int last = index->first_range[queue_id + 1] - 1;
+    if (last < index->first_range[queue_id]) return 0;
+    return index->ranges[last].offset + index->ranges[last].length;
+}
+
+static void index_mismatch(void) {
+    fprintf(stderr, "Error: Queue index does not match input file\n");
+    exit(EXIT_FAILURE);
+}
+
+/* Reads one range line by line with the same fgets split as read_input_stream,
+ * so memory stays bounded by the line buffer however long the range is. */
+static void read_range(FILE* file, const QueueRange* range, ProcessList* list) {
+    if (fseeko(file, (off_t)range->offset, SEEK_SET) != 0) index_mismatch();
+    
+    char line[256];
+    uint64_t remaining = range->length;
+    int process_id = range->first_id;
+    
+    while (remaining > 0) {
+        if (!fgets(line, sizeof(line), file)) index_mismatch();
+        uint64_t length = strlen(line);
+        if (length > remaining) index_mismatch();
+        remaining -= length;
+        
+        Process* p = parse_process_line(line, process_id, 1);
+        if (p) {
+            if (p->queue_id != range->queue_id) index_mismatch();
+            add_process(list, p);
+            process_id++;
+        }
+    }
+}
+
+ProcessList* read_indexed_queues(const char* trace_filename, const QueueIndex* index,
+                                 const int* queue_ids, int queue_id_count) {
+    FILE* file = fopen(trace_filename, "r");
+    if (!file) {
+        perror("Error opening input file");
+        exit(EXIT_FAILURE);
+    }
+    
+    ProcessList* list = create_list();
+    
+    for (int i = 0; i < queue_id_count; i++) {
+        int q = queue_ids[i];
+        if (q < 0 || q >= index->queue_count) continue;
+        
+        for (int r = index->first_range[q]; r < index->first_range[q + 1]; r++) {
+            read_range(file, &index->ranges[r], list);
+        }
+    }
+    
+    fclose(file);
+    return list;
+}
@@ -0,0 +1,51 @@
+#ifndef QUEUE_INDEX_H
+#define QUEUE_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "linked_list.h"
+
+/*
+ * Sidecar index "<trace>.qidx" mapping each queue_id to the byte ranges of
+ * the trace that hold its lines. A range covers consecutive valid lines of a
+ * single queue; first_id is the process id read_input_file would assign to
+ * its first line, so selective loads keep the same ids as a full read.
+ */
+typedef struct {
+    uint64_t offset;
+    uint64_t length;
+    int32_t queue_id;
+    int32_t first_id;
+} QueueRange;
+
+typedef struct {
+    uint64_t source_size;
+    int64_t source_mtime;
+    int64_t source_mtime_nsec;
+    uint64_t source_inode;
+    int queue_count;
+    int range_count;
+    int range_capacity;
+    QueueRange* ranges;
+    int* first_range;
+} QueueIndex;
+
+void queue_index_filename(const char* trace_filename, char* buffer, size_t size);
+void build_queue_index(const char* trace_filename, QueueIndex* index);
+int save_queue_index(const QueueIndex* index, const char* index_filename);
+int load_queue_index(QueueIndex* index, const char* index_filename, const char* trace_filename);
+void open_queue_index(const char* trace_filename, QueueIndex* index);
+void free_queue_index(QueueIndex* index);
+
+/* Incremental form of build_queue_index for readers that already walk the
+ * trace line by line; offsets and lengths are in bytes as fgets returns them. */
+void begin_queue_index(const char* trace_filename, QueueIndex* index);
+void index_queue_line(QueueIndex* index, uint64_t offset, uint64_t length, int queue_id, int process_id);
+void finish_queue_index(QueueIndex* index);
+
+uint64_t queue_end_offset(const QueueIndex* index, int queue_id);
+
+ProcessList* read_indexed_queues(const char* trace_filename, const QueueIndex* index,
+                                 const int* queue_ids, int queue_id_count);
+
+#endif
@@ -0,0 +1,185 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "result_file.h"
+
+static void write_padding(ResultFileWriter* writer) {
+    static const char zeros[8] = {0};
+    size_t padding = (8 - writer->offset % 8) % 8;
+    fwrite(zeros, 1, padding, writer->file);
+    writer->offset += padding;
+}
+
+static uint64_t write_array(ResultFileWriter* writer, const int* values, int count) {
+    if (!values) return 0;
+    
+    write_padding(writer);
+    uint64_t offset = writer->offset;
+    fwrite(values, sizeof(int32_t), count, writer->file);
+    writer->offset += (uint64_t)count * sizeof(int32_t);
+    return offset;
+}
+
+int result_writer_open(ResultFileWriter* writer, const char* filename) {
+    writer->file = fopen(filename, "wb");
+    if (!writer->file) {
+        perror("Error opening output file");
+        return -1;
+    }
+    
+    ResultFileHeader header;
+    memset(&header, 0, sizeof(header));
+    fwrite(&header, sizeof(header), 1, writer->file);
+    
+    writer->offset = sizeof(header);
+    writer->entries = NULL;
+    writer->count = 0;
+    writer->capacity = 0;
+    return 0;
+}
+
+void result_writer_add(ResultFileWriter* writer, const ScheduleResult* result) {
+    if (!result) return;
+    
+    if (writer->count == writer->capacity) {
+        writer->capacity = writer->capacity ? writer->capacity * 2 : 16;
+        writer->entries = (ResultFileEntry*)realloc(writer->entries, writer->capacity * sizeof(ResultFileEntry));
+        if (!writer->entries) {
+            perror("Failed to grow result directory");
+            exit(EXIT_FAILURE);
+        }
+    }
+    
+    ResultFileEntry* entry = &writer->entries[writer->count++];
+    memset(entry, 0, sizeof(*entry));
+    entry->queue_id = result->queue_id;
+    entry->algorithm = result->algorithm;
+    entry->process_count = result->process_count;
+    entry->max_waiting = result->max_waiting;
+    entry->makespan = result->makespan;
+    entry->average_waiting = result->average_waiting;
+    entry->average_turnaround = result->average_turnaround;
+    entry->waiting_offset = write_array(writer, result->waiting_times, result->process_count);
+    entry->turnaround_offset = write_array(writer, result->turnaround_times, result->process_count);
+    entry->completion_offset = write_array(writer, result->completion_times, result->process_count);
+}
+
+int result_writer_close(ResultFileWriter* writer) {
+    write_padding(writer);
+    
+    ResultFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, RESULT_FILE_MAGIC, sizeof(RESULT_FILE_MAGIC));
+    header.version = RESULT_FILE_VERSION;
+    header.byte_order = RESULT_FILE_BYTE_ORDER;
+    header.record_count = writer->count;
+    header.directory_offset = writer->offset;
+    
+    fwrite(writer->entries, sizeof(ResultFileEntry), writer->count, writer->file);
+    
+    int status = ferror(writer->file) ? -1 : 0;
+    if (fseek(writer->file, 0, SEEK_SET) != 0 ||
+        fwrite(&header, sizeof(header), 1, writer->file) != 1) {
+        perror("Error writing result header");
+        status = -1;
+    }
+    if (fflush(writer->file) != 0 || ferror(writer->file)) status = -1;
+    if (fclose(writer->file) != 0) status = -1;
+    
+    free(writer->entries);
+    writer->entries = NULL;
+    writer->file = NULL;
+    return status;
+}
+
+static int array_in_bounds(uint64_t offset, int32_t count, size_t size) {
+    if (offset == 0) return 1;
+    if (offset % sizeof(int32_t) != 0 || offset < sizeof(ResultFileHeader) || offset > size) return 0;
+    return (uint64_t)count * sizeof(int32_t) <= size - offset;
+}
+
+static int entry_in_bounds(const ResultFileEntry* entry, size_t size) {
+    return entry->process_count >= 0 &&
+           array_in_bounds(entry->waiting_offset, entry->process_count, size) &&
+           array_in_bounds(entry->turnaround_offset, entry->process_count, size) &&
+           array_in_bounds(entry->completion_offset, entry->process_count, size);
+}
+
+int result_file_map(ResultFile* results, const char* filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        perror("Error opening result file");
+        return -1;
+    }
+    
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(ResultFileHeader)) {
+        fprintf(stderr, "Error: %s is not a result file\n", filename);
+        close(fd);
+        return -1;
+    }
+    
+    results->size = info.st_size;
+    results->base = mmap(NULL, results->size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (results->base == MAP_FAILED) {
+        perror("Error mapping result file");
+        return -1;
+    }
+    
+    results->header = (const ResultFileHeader*)results->base;
+    const ResultFileHeader* header = results->header;
+    if (memcmp(header->magic, RESULT_FILE_MAGIC, sizeof(RESULT_FILE_MAGIC)) != 0 ||
+        header->version != RESULT_FILE_VERSION ||
+        header->byte_order != RESULT_FILE_BYTE_ORDER ||
+        header->directory_offset % 8 != 0 || header->directory_offset > results->size ||
+        header->directory_offset + (uint64_t)header->record_count * sizeof(ResultFileEntry) > results->size) {
+        fprintf(stderr, "Error: %s is not a compatible result file\n", filename);
+        munmap(results->base, results->size);
+        return -1;
+    }
+    
+    results->entries = (const ResultFileEntry*)((const char*)results->base + header->directory_offset);
+    for (uint32_t r = 0; r < header->record_count; r++) {
+        if (!entry_in_bounds(&results->entries[r], results->size)) {
+            fprintf(stderr, "Error: %s has a corrupt record %u\n", filename, r);
+            munmap(results->base, results->size);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+const int32_t* result_file_array(const ResultFile* results, uint64_t offset) {
+    if (offset == 0) return NULL;
+    return (const int32_t*)((const char*)results->base + offset);
+}
+
+void result_file_unmap(ResultFile* results) {
+    if (results->base && results->base != MAP_FAILED) munmap(results->base, results->size);
+    results->base = NULL;
+}
+
+void dump_result_file(const char* filename) {
+    ResultFile results;
+    if (result_file_map(&results, filename) != 0) exit(EXIT_FAILURE);
+    
+    for (uint32_t r = 0; r < results.header->record_count; r++) {
+        const ResultFileEntry* entry = &results.entries[r];
+        const int32_t* waiting = result_file_array(&results, entry->waiting_offset);
+        
+        printf("%d:%d", entry->queue_id, entry->algorithm);
+        for (int i = 0; waiting && i < entry->process_count; i++) {
+            printf(":%d", waiting[i]);
+        }
+        printf(":%.2f\n", entry->average_waiting);
+    }
+    
+    result_file_unmap(&results);
+}
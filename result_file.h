@@ -0,0 +1,70 @@
+#ifndef RESULT_FILE_H
+#define RESULT_FILE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "scheduler.h"
+
+/*
+ * Columnar binary result file, laid out so consumers can mmap it directly:
+ *
+ *   ResultFileHeader                      at offset 0
+ *   int32 arrays, each 8-byte aligned     waiting, turnaround, completion per record
+ *   ResultFileEntry[record_count]         at header.directory_offset
+ *
+ * All integers are in host byte order; byte_order lets readers detect a
+ * mismatch. Array offsets of 0 mean the array was not written.
+ */
+#define RESULT_FILE_MAGIC "CPERES1"
+#define RESULT_FILE_VERSION 1
+#define RESULT_FILE_BYTE_ORDER 0x01020304u
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t record_count;
+    uint32_t reserved;
+    uint64_t directory_offset;
+} ResultFileHeader;
+
+typedef struct {
+    int32_t queue_id;
+    int32_t algorithm;
+    int32_t process_count;
+    int32_t max_waiting;
+    int32_t makespan;
+    int32_t reserved;
+    double average_waiting;
+    double average_turnaround;
+    uint64_t waiting_offset;
+    uint64_t turnaround_offset;
+    uint64_t completion_offset;
+} ResultFileEntry;
+
+typedef struct {
+    FILE* file;
+    uint64_t offset;
+    ResultFileEntry* entries;
+    int count;
+    int capacity;
+} ResultFileWriter;
+
+typedef struct {
+    void* base;
+    size_t size;
+    const ResultFileHeader* header;
+    const ResultFileEntry* entries;
+} ResultFile;
+
+int result_writer_open(ResultFileWriter* writer, const char* filename);
+void result_writer_add(ResultFileWriter* writer, const ScheduleResult* result);
+int result_writer_close(ResultFileWriter* writer);
+
+int result_file_map(ResultFile* results, const char* filename);
+const int32_t* result_file_array(const ResultFile* results, uint64_t offset);
+void result_file_unmap(ResultFile* results);
+void dump_result_file(const char* filename);
+
+#endif
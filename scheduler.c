@@ -2,127 +2,140 @@
 #include <stdlib.h>
 #include "scheduler.h"
 #include "linked_list.h"
+#include "trace.h"
+#include "parallel.h"
 
-void fcfs_schedule(ProcessList* list) {
-    if (!list || list->count < 1) return;
-    
-    ProcessList* working_list = copy_list(list);
-    
-    sort_by_arrival(working_list);
-    
-    calculate_metrics(working_list);
-    
-    Process* orig = list->head;
-    Process* work = working_list->head;
-    
-    while (orig && work) {
-        if (orig->id == work->id) {
-            orig->waiting_time = work->waiting_time;
-            orig->turnaround_time = work->turnaround_time;
-            orig->completion_time = work->completion_time;
-            orig = orig->next;
-        }
-        work = work->next;
-    }
-    
-    free_list(working_list);
-}
+#define CMP_ASC(x, y) (((x) > (y)) - ((x) < (y)))
 
-void sjf_schedule(ProcessList* list) {
-    if (!list || list->count < 1) return;
-    
-    ProcessList* working_list = copy_list(list);
-    ProcessList* scheduled = create_list();
-    
-    int current_time = 0;
-    int total_processes = working_list->count;
-    
-    while (scheduled->count < total_processes) {
-        Process* next = find_min_burst(working_list, current_time);
-        
-        if (next) {
-            remove_process(working_list, next);
-            
-            if (current_time < next->arrival_time) {
-                current_time = next->arrival_time;
-            }
-            
-            next->waiting_time = current_time - next->arrival_time;
-            next->completion_time = current_time + next->burst_time;
-            next->turnaround_time = next->completion_time - next->arrival_time;
-            
-            current_time = next->completion_time;
-            add_process(scheduled, next);
-        } else {
-            current_time++;
-        }
+#define BY_ARRIVAL(a, b) \
+    ((a)->arrival_time != (b)->arrival_time ? CMP_ASC((a)->arrival_time, (b)->arrival_time) \
+                                            : CMP_ASC((a)->id, (b)->id))
+
+#define BY_BURST(a, b, now) CMP_ASC((a)->burst_time, (b)->burst_time)
+#define BY_LONGEST_BURST(a, b, now) CMP_ASC((b)->burst_time, (a)->burst_time)
+#define BY_PRIORITY(a, b, now) CMP_ASC((a)->priority, (b)->priority)
+#define BY_DEADLINE(a, b, now) CMP_ASC((a)->deadline, (b)->deadline)
+#define BY_RESPONSE_RATIO(a, b, now) \
+    CMP_ASC((long long)((now) - (b)->arrival_time + (b)->burst_time) * (a)->burst_time, \
+            (long long)((now) - (a)->arrival_time + (a)->burst_time) * (b)->burst_time)
+
+static Process** gather_processes(ProcessList* list) {
+    Process** items = (Process**)malloc(list->count * sizeof(Process*));
+    if (!items) {
+        perror("Failed to allocate schedule order");
+        exit(EXIT_FAILURE);
     }
     
-    Process* orig = list->head;
-    Process* sched = scheduled->head;
-    
-    while (orig && sched) {
-        if (orig->id == sched->id) {
-            orig->waiting_time = sched->waiting_time;
-            orig->turnaround_time = sched->turnaround_time;
-            orig->completion_time = sched->completion_time;
-            orig = orig->next;
-        }
-        sched = sched->next;
+    int i = 0;
+    for (Process* p = list->head; p; p = p->next) {
+        items[i++] = p;
     }
-    
-    free_list(working_list);
-    free_list(scheduled);
+    return items;
+}
+
+static Process** gather_by_arrival(ProcessList* list) {
+    Process** order = gather_processes(list);
+    parallel_sort_by_arrival(order, list->count);
+    return order;
 }
 
-void priority_schedule(ProcessList* list) {
+void fcfs_schedule(ProcessList* list) {
     if (!list || list->count < 1) return;
     
-    ProcessList* working_list = copy_list(list);
-    ProcessList* scheduled = create_list();
-    
-    int current_time = 0;
-    int total_processes = working_list->count;
+    Process** order = gather_by_arrival(list);
+    parallel_fcfs_times(order, list->count);
     
-    while (scheduled->count < total_processes) {
-        Process* next = find_highest_priority(working_list, current_time);
-        
-        if (next) {
-            remove_process(working_list, next);
-            
-            if (current_time < next->arrival_time) {
-                current_time = next->arrival_time;
+    if (trace_enabled) {
+        int current_time = 0;
+        for (int i = 0; i < list->count; i++) {
+            Process* p = order[i];
+            int start = p->completion_time - p->burst_time;
+            if (start > current_time) {
+                TRACE_EVENT(TRACE_IDLE, ALGORITHM_FCFS, p->queue_id, 0, current_time, start);
             }
-            
-            next->waiting_time = current_time - next->arrival_time;
-            next->completion_time = current_time + next->burst_time;
-            next->turnaround_time = next->completion_time - next->arrival_time;
-            
-            current_time = next->completion_time;
-            add_process(scheduled, next);
-        } else {
-            current_time++;
+            TRACE_EVENT(TRACE_DISPATCH, ALGORITHM_FCFS, p->queue_id, p->id, start, p->completion_time);
+            TRACE_EVENT(TRACE_COMPLETE, ALGORITHM_FCFS, p->queue_id, p->id, p->completion_time, p->completion_time);
+            current_time = p->completion_time;
         }
     }
     
-    Process* orig = list->head;
-    Process* sched = scheduled->head;
-    
-    while (orig && sched) {
-        if (orig->id == sched->id) {
-            orig->waiting_time = sched->waiting_time;
-            orig->turnaround_time = sched->turnaround_time;
-            orig->completion_time = sched->completion_time;
-            orig = orig->next;
-        }
-        sched = sched->next;
+    free(order);
+}
+
+/*
+ * Expands to a non-preemptive scheduler that, whenever the CPU frees up, runs
+ * the ready process ordered first by KEY_CMP(a, b, now), falling back to
+ * TIE_CMP(a, b) on equal keys. Both are macros so the comparison is inlined
+ * into the selection loop. Metrics are written straight into list's nodes and
+ * trace events are tagged with ALGORITHM.
+ */
+#define DEFINE_NONPREEMPTIVE_SCHEDULER(NAME, ALGORITHM, KEY_CMP, TIE_CMP)               \
+void NAME(ProcessList* list) {                                                          \
+    if (!list || list->count < 1) return;                                               \
+                                                                                        \
+    int total = list->count;                                                            \
+    Process** pending = gather_by_arrival(list);                                        \
+    Process** ready = (Process**)malloc(total * sizeof(Process*));                      \
+    if (!ready) {                                                                       \
+        perror("Failed to allocate ready queue");                                       \
+        exit(EXIT_FAILURE);                                                             \
+    }                                                                                   \
+                                                                                        \
+    int admitted = 0;                                                                   \
+    int ready_count = 0;                                                                \
+    int current_time = 0;                                                               \
+                                                                                        \
+    for (int done = 0; done < total; done++) {                                          \
+        if (ready_count == 0 && pending[admitted]->arrival_time > current_time) {       \
+            TRACE_EVENT(TRACE_IDLE, ALGORITHM, list->head->queue_id, 0,                 \
+                        current_time, pending[admitted]->arrival_time);                 \
+            current_time = pending[admitted]->arrival_time;                             \
+        }                                                                               \
+        while (admitted < total && pending[admitted]->arrival_time <= current_time) {   \
+            ready[ready_count++] = pending[admitted++];                                 \
+        }                                                                               \
+                                                                                        \
+        int best = 0;                                                                   \
+        for (int i = 1; i < ready_count; i++) {                                         \
+            int order = KEY_CMP(ready[i], ready[best], current_time);                   \
+            if (order < 0 || (order == 0 && TIE_CMP(ready[i], ready[best]) < 0)) {      \
+                best = i;                                                               \
+            }                                                                           \
+        }                                                                               \
+                                                                                        \
+        Process* next = ready[best];                                                    \
+        ready[best] = ready[--ready_count];                                             \
+                                                                                        \
+        next->waiting_time = current_time - next->arrival_time;                         \
+        next->completion_time = current_time + next->burst_time;                        \
+        next->turnaround_time = next->completion_time - next->arrival_time;             \
+        TRACE_EVENT(TRACE_DISPATCH, ALGORITHM, next->queue_id, next->id,                \
+                    current_time, next->completion_time);                               \
+        TRACE_EVENT(TRACE_COMPLETE, ALGORITHM, next->queue_id, next->id,                \
+                    next->completion_time, next->completion_time);                      \
+        current_time = next->completion_time;                                           \
+    }                                                                                   \
+                                                                                        \
+    free(pending);                                                                      \
+    free(ready);                                                                        \
+}
+
+DEFINE_NONPREEMPTIVE_SCHEDULER(sjf_schedule, ALGORITHM_SJF, BY_BURST, BY_ARRIVAL)
+DEFINE_NONPREEMPTIVE_SCHEDULER(ljf_schedule, ALGORITHM_LJF, BY_LONGEST_BURST, BY_ARRIVAL)
+DEFINE_NONPREEMPTIVE_SCHEDULER(priority_schedule, ALGORITHM_PRIORITY, BY_PRIORITY, BY_ARRIVAL)
+DEFINE_NONPREEMPTIVE_SCHEDULER(hrrn_schedule, ALGORITHM_HRRN, BY_RESPONSE_RATIO, BY_ARRIVAL)
+DEFINE_NONPREEMPTIVE_SCHEDULER(edf_schedule, ALGORITHM_EDF, BY_DEADLINE, BY_ARRIVAL)
+
+static int* allocate_times(int count) {
+    int* times = (int*)malloc(count * sizeof(int));
+    if (!times) {
+        perror("Failed to allocate result times");
+        exit(EXIT_FAILURE);
     }
-    
-    free_list(working_list);
-    free_list(scheduled);
+    return times;
 }
 
-ScheduleResult* create_result(int queue_id, int algorithm, ProcessList* list) {
+ScheduleResult* create_result(int queue_id, int algorithm, ProcessList* list, int detail) {
     if (!list || list->count == 0) return NULL;
     
     ScheduleResult* result = (ScheduleResult*)malloc(sizeof(ScheduleResult));
@@ -134,32 +147,46 @@ ScheduleResult* create_result(int queue_id, int algorithm, ProcessList* list) {
     result->queue_id = queue_id;
     result->algorithm = algorithm;
     result->process_count = list->count;
-    
-    result->waiting_times = (int*)malloc(list->count * sizeof(int));
-    if (!result->waiting_times) {
-        perror("Failed to allocate waiting times");
-        free(result);
-        exit(EXIT_FAILURE);
-    }
-    
-    Process* current = list->head;
-    int i = 0;
-    float total = 0.0f;
-    
-    while (current) {
-        result->waiting_times[i] = current->waiting_time;
-        total += current->waiting_time;
-        i++;
-        current = current->next;
+    result->waiting_times = detail >= RESULT_WAITING ? allocate_times(list->count) : NULL;
+    result->turnaround_times = detail >= RESULT_FULL ? allocate_times(list->count) : NULL;
+    result->completion_times = detail >= RESULT_FULL ? allocate_times(list->count) : NULL;
+    
+    MetricTotals totals = {0, 0, 0, 0};
+    
+    if (parallel_parts(list->count) > 1) {
+        Process** items = gather_processes(list);
+        parallel_collect_metrics(items, list->count, result->waiting_times, result->turnaround_times,
+                                 result->completion_times, &totals);
+        free(items);
+    } else {
+        Process* current = list->head;
+        int i = 0;
+        
+        while (current) {
+            if (result->waiting_times) result->waiting_times[i] = current->waiting_time;
+            if (result->turnaround_times) result->turnaround_times[i] = current->turnaround_time;
+            if (result->completion_times) result->completion_times[i] = current->completion_time;
+            totals.total_waiting += current->waiting_time;
+            totals.total_turnaround += current->turnaround_time;
+            if (current->waiting_time > totals.max_waiting) totals.max_waiting = current->waiting_time;
+            if (current->completion_time > totals.makespan) totals.makespan = current->completion_time;
+            i++;
+            current = current->next;
+        }
     }
     
-    result->average_waiting = total / list->count;
+    result->max_waiting = totals.max_waiting;
+    result->makespan = totals.makespan;
+    result->average_waiting = (float)((double)totals.total_waiting / list->count);
+    result->average_turnaround = (float)((double)totals.total_turnaround / list->count);
     return result;
 }
 
 void free_result(ScheduleResult* result) {
     if (!result) return;
     if (result->waiting_times) free(result->waiting_times);
+    if (result->turnaround_times) free(result->turnaround_times);
+    if (result->completion_times) free(result->completion_times);
     free(result);
 }
 
@@ -170,9 +197,8 @@ void print_result(ScheduleResult* result) {
     }
     
     printf("Queue %d, Algorithm %d: ", result->queue_id, result->algorithm);
-    for (int i = 0; i < result->process_count; i++) {
-        printf("%d", result->waiting_times[i]);
-        if (i < result->process_count - 1) printf(":");
+    for (int i = 0; result->waiting_times && i < result->process_count; i++) {
+        printf("%d:", result->waiting_times[i]);
     }
-    printf(":%.2f\n", result->average_waiting);
+    printf("%.2f\n", result->average_waiting);
 }
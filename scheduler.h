@@ -3,19 +3,38 @@
 
 #include "linked_list.h"
 
+#define ALGORITHM_FCFS 1
+#define ALGORITHM_SJF 2
+#define ALGORITHM_PRIORITY 3
+#define ALGORITHM_LJF 4
+#define ALGORITHM_HRRN 5
+#define ALGORITHM_EDF 6
+
 void fcfs_schedule(ProcessList* list);
 void sjf_schedule(ProcessList* list);
 void priority_schedule(ProcessList* list);
+void ljf_schedule(ProcessList* list);
+void hrrn_schedule(ProcessList* list);
+void edf_schedule(ProcessList* list);
+
+#define RESULT_SUMMARY 0
+#define RESULT_WAITING 1
+#define RESULT_FULL 2
 
 typedef struct {
     int queue_id;
     int algorithm;
     int* waiting_times;
+    int* turnaround_times;
+    int* completion_times;
     int process_count;
     float average_waiting;
+    float average_turnaround;
+    int max_waiting;
+    int makespan;
 } ScheduleResult;
 
-ScheduleResult* create_result(int queue_id, int algorithm, ProcessList* list);
+ScheduleResult* create_result(int queue_id, int algorithm, ProcessList* list, int detail);
 void free_result(ScheduleResult* result);
 void print_result(ScheduleResult* result);
 
@@ -0,0 +1,208 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "simulation.h"
+#include "linked_list.h"
+#include "scheduler.h"
+#include "utils.h"
+#include "result_file.h"
+
+typedef struct {
+    int id;
+    const char* name;
+    const char* label;
+    void (*schedule)(ProcessList* list);
+} Algorithm;
+
+static const Algorithm algorithms_table[ALGORITHM_COUNT] = {
+    {ALGORITHM_FCFS, "fcfs", "FCFS", fcfs_schedule},
+    {ALGORITHM_SJF, "sjf", "SJF", sjf_schedule},
+    {ALGORITHM_PRIORITY, "priority", "Priority", priority_schedule},
+    {ALGORITHM_LJF, "ljf", "LJF", ljf_schedule},
+    {ALGORITHM_HRRN, "hrrn", "HRRN", hrrn_schedule},
+    {ALGORITHM_EDF, "edf", "EDF", edf_schedule},
+};
+
+int result_detail(const SimulationOptions* options) {
+    if (options->summary_only) return RESULT_SUMMARY;
+    if (options->format == OUTPUT_BINARY) return RESULT_FULL;
+    return RESULT_WAITING;
+}
+
+int parse_algorithms(const char* text) {
+    int mask = 0;
+    const char* c = text;
+    
+    while (*c) {
+        size_t length = strcspn(c, ",");
+        int found = 0;
+        for (int a = 0; a < ALGORITHM_COUNT; a++) {
+            const Algorithm* algorithm = &algorithms_table[a];
+            char id[4];
+            snprintf(id, sizeof(id), "%d", algorithm->id);
+            if ((strlen(algorithm->name) == length && strncmp(c, algorithm->name, length) == 0) ||
+                (strlen(id) == length && strncmp(c, id, length) == 0)) {
+                mask |= ALGORITHM_BIT(algorithm->id);
+                found = 1;
+            }
+        }
+        if (!found) return -1;
+        c += length;
+        if (*c == ',') c++;
+    }
+    
+    return mask ? mask : -1;
+}
+
+ScheduleResult** schedule_queue(int queue_id, ProcessList* queue_list, int detail, int algorithms, int verbose) {
+    ScheduleResult** queue_results = (ScheduleResult**)malloc(ALGORITHM_COUNT * sizeof(ScheduleResult*));
+    if (!queue_results) {
+        perror("Failed to allocate queue results");
+        exit(EXIT_FAILURE);
+    }
+    
+    for (int a = 0; a < ALGORITHM_COUNT; a++) {
+        queue_results[a] = NULL;
+    }
+    
+    if (!queue_list || queue_list->count == 0) {
+        return queue_results;
+    }
+    
+    if (verbose) printf("\nProcessing Queue %d (%d processes):\n", queue_id, queue_list->count);
+    
+    for (int a = 0; a < ALGORITHM_COUNT; a++) {
+        const Algorithm* algorithm = &algorithms_table[a];
+        if (!(algorithms & ALGORITHM_BIT(algorithm->id))) continue;
+        
+        if (verbose) printf("  Running %s... ", algorithm->label);
+        ProcessList* working_list = copy_list(queue_list);
+        algorithm->schedule(working_list);
+        queue_results[a] = create_result(queue_id, algorithm->id, working_list, detail);
+        if (verbose) printf("Done. AWT: %.2f\n", queue_results[a]->average_waiting);
+        free_list(working_list);
+    }
+    
+    return queue_results;
+}
+
+ScheduleResult*** schedule_queues(ProcessList* all_processes, int* queue_count, int detail, int algorithms, int verbose) {
+    ProcessList** queues = separate_by_queue(all_processes, queue_count);
+    if (verbose) printf("Found %d queues.\n", *queue_count);
+    
+    ScheduleResult*** all_results = (ScheduleResult***)malloc(*queue_count * sizeof(ScheduleResult**));
+    if (!all_results && *queue_count > 0) {
+        perror("Failed to allocate results array");
+        exit(EXIT_FAILURE);
+    }
+    
+    for (int q = 0; q < *queue_count; q++) {
+        all_results[q] = schedule_queue(q, queues[q], detail, algorithms, verbose);
+        if (queues[q]) free_list(queues[q]);
+    }
+    free(queues);
+    
+    return all_results;
+}
+
+void free_queue_results(ScheduleResult** queue_results) {
+    if (!queue_results) return;
+    for (int a = 0; a < ALGORITHM_COUNT; a++) {
+        if (queue_results[a]) free_result(queue_results[a]);
+    }
+    free(queue_results);
+}
+
+void free_results(ScheduleResult*** results, int queue_count) {
+    if (!results) return;
+    for (int q = 0; q < queue_count; q++) {
+        free_queue_results(results[q]);
+    }
+    free(results);
+}
+
+void run_simulation(ProcessList* all_processes, const char* output_filename, const SimulationOptions* options) {
+    int queue_count;
+    ScheduleResult*** all_results = schedule_queues(all_processes, &queue_count, result_detail(options),
+                                                 options->algorithms, 1);
+    
+    if (options->format == OUTPUT_BINARY) {
+        write_results_to_binary_file(output_filename, all_results, queue_count);
+    } else {
+        write_results_to_file(output_filename, all_results, queue_count);
+    }
+    write_results_to_screen(all_results, queue_count);
+    
+    free_results(all_results, queue_count);
+}
+
+void write_queue_results(FILE* file, ScheduleResult** queue_results) {
+    for (int a = 0; a < ALGORITHM_COUNT; a++) {
+        ScheduleResult* result = queue_results[a];
+        if (!result) continue;
+        
+        fprintf(file, "%d:%d", result->queue_id, result->algorithm);
+        
+        for (int i = 0; result->waiting_times && i < result->process_count; i++) {
+            fprintf(file, ":%d", result->waiting_times[i]);
+        }
+        
+        fprintf(file, ":%.2f\n", result->average_waiting);
+    }
+}
+
+void write_results(FILE* file, ScheduleResult*** results, int queue_count) {
+    for (int q = 0; q < queue_count; q++) {
+        write_queue_results(file, results[q]);
+    }
+}
+
+void write_results_to_file(const char* filename, ScheduleResult*** results, int queue_count) {
+    FILE* file = fopen(filename, "w");
+    if (!file) {
+        perror("Error opening output file");
+        exit(EXIT_FAILURE);
+    }
+    
+    write_results(file, results, queue_count);
+    
+    int failed = ferror(file);
+    if (fclose(file) != 0 || failed) {
+        fprintf(stderr, "Error writing %s\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    printf("\nResults written to %s\n", filename);
+}
+
+void write_results_to_binary_file(const char* filename, ScheduleResult*** results, int queue_count) {
+    ResultFileWriter writer;
+    if (result_writer_open(&writer, filename) != 0) {
+        exit(EXIT_FAILURE);
+    }
+    
+    for (int q = 0; q < queue_count; q++) {
+        for (int a = 0; a < ALGORITHM_COUNT; a++) {
+            result_writer_add(&writer, results[q][a]);
+        }
+    }
+    
+    if (result_writer_close(&writer) != 0) {
+        fprintf(stderr, "Error writing %s\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    printf("\nBinary results written to %s\n", filename);
+}
+
+void write_results_to_screen(ScheduleResult*** results, int queue_count) {
+    printf("\nFinal Results:\n");
+    printf("==============\n");
+    
+    for (int q = 0; q < queue_count; q++) {
+        for (int a = 0; a < ALGORITHM_COUNT; a++) {
+            ScheduleResult* result = results[q][a];
+            if (!result) continue;
+            
+            print_result(result);
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <stdio.h>
+#include "linked_list.h"
+#include "scheduler.h"
+
+#define ALGORITHM_COUNT 6
+#define ALGORITHM_BIT(id) (1 << ((id) - 1))
+#define ALGORITHMS_DEFAULT (ALGORITHM_BIT(ALGORITHM_FCFS) | ALGORITHM_BIT(ALGORITHM_SJF) | ALGORITHM_BIT(ALGORITHM_PRIORITY))
+
+#define OUTPUT_TEXT 0
+#define OUTPUT_BINARY 1
+
+typedef struct {
+    int format;
+    int summary_only;
+    int algorithms;
+} SimulationOptions;
+
+int result_detail(const SimulationOptions* options);
+int parse_algorithms(const char* text);
+ScheduleResult** schedule_queue(int queue_id, ProcessList* queue_list, int detail, int algorithms, int verbose);
+ScheduleResult*** schedule_queues(ProcessList* all_processes, int* queue_count, int detail, int algorithms, int verbose);
+void free_queue_results(ScheduleResult** queue_results);
+void free_results(ScheduleResult*** results, int queue_count);
+
+void run_simulation(ProcessList* all_processes, const char* output_filename, const SimulationOptions* options);
+void write_queue_results(FILE* file, ScheduleResult** queue_results);
+void write_results(FILE* file, ScheduleResult*** results, int queue_count);
+void write_results_to_file(const char* filename, ScheduleResult*** results, int queue_count);
+void write_results_to_binary_file(const char* filename, ScheduleResult*** results, int queue_count);
+void write_results_to_screen(ScheduleResult*** results, int queue_count);
+
+#endif
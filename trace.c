@@ -0,0 +1,251 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include "trace.h"
+
+#define TRACE_RING_SIZE (1 << 14)
+#define TRACE_MAGIC "CPETRC1"
+
+typedef struct TraceRing {
+    TraceEvent events[TRACE_RING_SIZE];
+    uint32_t head;
+    uint32_t tail;
+    struct TraceRing* next;
+} TraceRing;
+
+int trace_enabled = 0;
+
+static FILE* trace_file = NULL;
+static TraceRing* rings = NULL;
+static pthread_mutex_t rings_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t writer_thread;
+static int writer_stop = 0;
+static int writer_failed = 0;
+static int trace_generation = 0;
+
+static __thread TraceRing* local_ring = NULL;
+static __thread int local_generation = 0;
+
+static TraceRing* register_ring(void) {
+    TraceRing* ring = (TraceRing*)calloc(1, sizeof(TraceRing));
+    if (!ring) {
+        perror("Failed to allocate trace ring");
+        exit(EXIT_FAILURE);
+    }
+    
+    pthread_mutex_lock(&rings_lock);
+    ring->next = rings;
+    rings = ring;
+    pthread_mutex_unlock(&rings_lock);
+    
+    local_ring = ring;
+    local_generation = trace_generation;
+    return ring;
+}
+
+void trace_record(int type, int algorithm, int queue_id, int pid, int start, int end) {
+    TraceRing* ring = local_ring;
+    if (!ring || local_generation != trace_generation) ring = register_ring();
+    
+    uint32_t head = ring->head;
+    while (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) == TRACE_RING_SIZE) {
+        sched_yield();
+    }
+    
+    TraceEvent* event = &ring->events[head & (TRACE_RING_SIZE - 1)];
+    event->type = (uint8_t)type;
+    event->algorithm = (uint8_t)algorithm;
+    event->reserved = 0;
+    event->queue_id = queue_id;
+    event->pid = pid;
+    event->start = start;
+    event->end = end;
+    
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+static int drain_rings(void) {
+    int drained = 0;
+    
+    pthread_mutex_lock(&rings_lock);
+    TraceRing* ring = rings;
+    pthread_mutex_unlock(&rings_lock);
+    
+    for (; ring; ring = ring->next) {
+        uint32_t tail = ring->tail;
+        uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        
+        while (tail != head) {
+            uint32_t index = tail & (TRACE_RING_SIZE - 1);
+            uint32_t run = head - tail;
+            if (run > TRACE_RING_SIZE - index) run = TRACE_RING_SIZE - index;
+            
+            /* Keep draining after a failed write so producers never block
+             * on a full ring; trace_stop reports the error. */
+            if (fwrite(&ring->events[index], sizeof(TraceEvent), run, trace_file) != run) {
+                writer_failed = 1;
+            }
+            tail += run;
+            drained += run;
+        }
+        
+        __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+    }
+    
+    return drained;
+}
+
+static void* writer_main(void* arg) {
+    (void)arg;
+    struct timespec pause = {0, 1000000};
+    
+    while (!__atomic_load_n(&writer_stop, __ATOMIC_ACQUIRE)) {
+        if (drain_rings() == 0) nanosleep(&pause, NULL);
+    }
+    drain_rings();
+    
+    return NULL;
+}
+
+int trace_start(const char* filename) {
+    trace_file = fopen(filename, "wb");
+    if (!trace_file) {
+        perror("Error opening trace file");
+        return -1;
+    }
+    
+    trace_generation++;
+    writer_stop = 0;
+    writer_failed = fwrite(TRACE_MAGIC, 1, sizeof(TRACE_MAGIC), trace_file) != sizeof(TRACE_MAGIC);
+    if (pthread_create(&writer_thread, NULL, writer_main, NULL) != 0) {
+        perror("Failed to start trace writer");
+        fclose(trace_file);
+        trace_file = NULL;
+        return -1;
+    }
+    
+    trace_enabled = 1;
+    return 0;
+}
+
+/* Must only be called once no thread is inside a scheduler any more.
+ * Returns -1 if any part of the trace could not be written. */
+int trace_stop(void) {
+    if (!trace_file) return 0;
+    
+    trace_enabled = 0;
+    __atomic_store_n(&writer_stop, 1, __ATOMIC_RELEASE);
+    pthread_join(writer_thread, NULL);
+    
+    int failed = writer_failed || ferror(trace_file);
+    if (fclose(trace_file) != 0) failed = 1;
+    trace_file = NULL;
+    
+    pthread_mutex_lock(&rings_lock);
+    while (rings) {
+        TraceRing* next = rings->next;
+        free(rings);
+        rings = next;
+    }
+    pthread_mutex_unlock(&rings_lock);
+    
+    return failed ? -1 : 0;
+}
+
+static int close_export(FILE* output, FILE* input, const char* filename) {
+    int failed = ferror(output);
+    if (fclose(output) != 0) failed = 1;
+    fclose(input);
+    if (failed) {
+        fprintf(stderr, "Error writing trace export %s\n", filename);
+        return -1;
+    }
+    return 0;
+}
+
+static FILE* open_trace(const char* filename) {
+    FILE* file = fopen(filename, "rb");
+    if (!file) {
+        perror("Error opening trace file");
+        return NULL;
+    }
+    
+    char magic[sizeof(TRACE_MAGIC)];
+    if (fread(magic, 1, sizeof(magic), file) != sizeof(magic) ||
+        memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0) {
+        fprintf(stderr, "Error: %s is not a trace file\n", filename);
+        fclose(file);
+        return NULL;
+    }
+    
+    return file;
+}
+
+int trace_export_chrome(const char* trace_filename, const char* json_filename) {
+    FILE* input = open_trace(trace_filename);
+    if (!input) return -1;
+    
+    FILE* output = fopen(json_filename, "w");
+    if (!output) {
+        perror("Error opening trace export file");
+        fclose(input);
+        return -1;
+    }
+    
+    fprintf(output, "{\"traceEvents\":[");
+    
+    TraceEvent event;
+    int first = 1;
+    while (fread(&event, sizeof(event), 1, input) == 1) {
+        fprintf(output, first ? "\n" : ",\n");
+        first = 0;
+        
+        switch (event.type) {
+        case TRACE_DISPATCH:
+            fprintf(output, "{\"name\":\"P%d\",\"ph\":\"X\",\"ts\":%d,\"dur\":%d,\"pid\":%d,\"tid\":%d}",
+                    event.pid, event.start, event.end - event.start, event.queue_id, event.algorithm);
+            break;
+        case TRACE_IDLE:
+            fprintf(output, "{\"name\":\"idle\",\"ph\":\"X\",\"ts\":%d,\"dur\":%d,\"pid\":%d,\"tid\":%d}",
+                    event.start, event.end - event.start, event.queue_id, event.algorithm);
+            break;
+        default:
+            fprintf(output, "{\"name\":\"P%d done\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%d,\"pid\":%d,\"tid\":%d}",
+                    event.pid, event.end, event.queue_id, event.algorithm);
+            break;
+        }
+    }
+    
+    fprintf(output, "\n]}\n");
+    return close_export(output, input, json_filename);
+}
+
+int trace_export_gantt(const char* trace_filename, const char* gantt_filename) {
+    FILE* input = open_trace(trace_filename);
+    if (!input) return -1;
+    
+    FILE* output = fopen(gantt_filename, "w");
+    if (!output) {
+        perror("Error opening trace export file");
+        fclose(input);
+        return -1;
+    }
+    
+    TraceEvent event;
+    while (fread(&event, sizeof(event), 1, input) == 1) {
+        if (event.type == TRACE_DISPATCH) {
+            fprintf(output, "%d:%d:%d:%d:%d\n", event.queue_id, event.algorithm,
+                    event.pid, event.start, event.end);
+        } else if (event.type == TRACE_IDLE) {
+            fprintf(output, "%d:%d:-:%d:%d\n", event.queue_id, event.algorithm,
+                    event.start, event.end);
+        }
+    }
+    
+    return close_export(output, input, gantt_filename);
+}
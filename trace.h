@@ -0,0 +1,40 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+#define TRACE_DISPATCH 1
+#define TRACE_IDLE 2
+#define TRACE_COMPLETE 3
+
+/* One 20-byte record per event, stored in host byte order after an 8-byte "CPETRC1" header. */
+typedef struct {
+    uint8_t type;
+    uint8_t algorithm;
+    uint16_t reserved;
+    int32_t queue_id;
+    int32_t pid;
+    int32_t start;
+    int32_t end;
+} TraceEvent;
+
+extern int trace_enabled;
+
+#ifdef NO_TRACE
+#define TRACE_EVENT(type, algorithm, queue_id, pid, start, end) ((void)0)
+#else
+#define TRACE_EVENT(type, algorithm, queue_id, pid, start, end)                       \
+    do {                                                                              \
+        if (__builtin_expect(trace_enabled, 0))                                       \
+            trace_record((type), (algorithm), (queue_id), (pid), (start), (end));     \
+    } while (0)
+#endif
+
+int trace_start(const char* filename);
+int trace_stop(void);
+void trace_record(int type, int algorithm, int queue_id, int pid, int start, int end);
+
+int trace_export_chrome(const char* trace_filename, const char* json_filename);
+int trace_export_gantt(const char* trace_filename, const char* gantt_filename);
+
+#endif
@@ -11,28 +11,45 @@ ProcessList* read_input_file(const char* filename) {
         exit(EXIT_FAILURE);
     }
     
+    ProcessList* list = read_input_stream(file);
+    
+    fclose(file);
+    return list;
+}
+
+ProcessList* read_input_stream(FILE* file) {
     ProcessList* list = create_list();
     char line[256];
     int process_id = 1;
     
     while (fgets(line, sizeof(line), file)) {
-        line[strcspn(line, "\n")] = '\0';
-        
-        if (strlen(line) == 0) continue;
-        
-        int burst, priority, arrival, queue_id;
-        if (sscanf(line, "%d:%d:%d:%d", &burst, &priority, &arrival, &queue_id) == 4) {
-            Process* p = create_process(process_id++, burst, priority, arrival, queue_id);
+        Process* p = parse_process_line(line, process_id, 1);
+        if (p) {
             add_process(list, p);
-        } else {
-            fprintf(stderr, "Warning: Invalid line format: %s\n", line);
+            process_id++;
         }
     }
     
-    fclose(file);
     return list;
 }
 
+Process* parse_process_line(char* line, int process_id, int warn) {
+    line[strcspn(line, "\n")] = '\0';
+    
+    if (strlen(line) == 0) return NULL;
+    
+    int burst, priority, arrival, queue_id, deadline;
+    int fields = sscanf(line, "%d:%d:%d:%d:%d", &burst, &priority, &arrival, &queue_id, &deadline);
+    if (fields < 4) {
+        if (warn) fprintf(stderr, "Warning: Invalid line format: %s\n", line);
+        return NULL;
+    }
+    
+    Process* p = create_process(process_id, burst, priority, arrival, queue_id);
+    if (fields == 5) p->deadline = deadline;
+    return p;
+}
+
 ProcessList** separate_by_queue(ProcessList* all_processes, int* queue_count) {
     if (!all_processes || !all_processes->head) {
         *queue_count = 0;
@@ -57,6 +74,7 @@ ProcessList** separate_by_queue(ProcessList* all_processes, int* queue_count) {
             Process* copy = create_process(current->id, current->burst_time,
                                           current->priority, current->arrival_time,
                                           current->queue_id);
+            copy->deadline = current->deadline;
             add_process(queues[current->queue_id], copy);
         }
         current = current->next;
@@ -1,11 +1,14 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <stdio.h>
 #include "linked_list.h"
 
 ProcessList* read_input_file(const char* filename);
+ProcessList* read_input_stream(FILE* file);
+Process* parse_process_line(char* line, int process_id, int warn);
 void write_output_file(const char* filename, ProcessList** results, int queue_count);
-void write_to_screen(ProcessList** results, int queue_count)
+void write_to_screen(ProcessList** results, int queue_count);
 void calculate_metrics(ProcessList* list);
 float calculate_average_waiting_time(ProcessList* list);
 